@@ -0,0 +1,224 @@
+#include "Inputs.h"
+#include "AST/TypeContext.h"
+#include "CodeGen/CodeGen.h"
+#include "CodeGen/CompilationCache.h"
+#include "CodeGen/IncrementalCompiler.h"
+#include "CodeGen/JIT.h"
+#include "CodeGen/ParallelCodeGen.h"
+#include "CodeGen/TypeEmitter.h"
+#include "Seman/Seman.h"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/raw_ostream.h>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+    // A parsed and checked program that CodeGen can run on repeatedly.
+    struct CheckedProgram {
+        explicit CheckedProgram(std::string Code) : Program(std::move(Code)),
+            SemanInfo(*Program.Mod->TyContext, Program.Reporter) {
+            SemanInfo.visit(*Program.Mod);
+        }
+
+        ParsedProgram Program;
+        Seman SemanInfo;
+    };
+
+    CodeGenOptions makeOptions(std::int64_t Level) {
+        CodeGenOptions Options;
+        Options.Opt = static_cast<OptLevel>(Level);
+        return Options;
+    }
+}
+
+static void BM_TypeEmitter(benchmark::State& State) {
+    TypeContext Context;
+    ErrorReporter Reporter;
+    Seman SemanInfo(Context, Reporter);
+    std::vector<const Type*> Types;
+    for (const auto Element : Context.getBuiltinTypes()) {
+        for (std::uint64_t Size = 1; Size <= 100; Size++) {
+            const auto Pointer = Context.getPointerType(Element);
+            const auto Array = Context.getArrayType(Pointer, Size);
+            Types.push_back(Pointer);
+            Types.push_back(Array);
+            Types.push_back(Context.getFunctionType(Element, { Pointer, Array }));
+        }
+    }
+    for (auto _ : State) {
+        llvm::LLVMContext LLVMContext;
+        TypeEmitter Emitter(LLVMContext, SemanInfo);
+        for (const auto Ty : Types) {
+            benchmark::DoNotOptimize(Emitter.emit(*Ty));
+        }
+    }
+    State.SetItemsProcessed(static_cast<std::int64_t>(State.iterations() * Types.size()));
+}
+BENCHMARK(BM_TypeEmitter);
+
+// Args: number of functions, -O level.
+static void BM_CodeGen(benchmark::State& State) {
+    CheckedProgram Checked(generateCodeGenProgram(static_cast<std::size_t>(State.range(0))));
+    const auto Options = makeOptions(State.range(1));
+    for (auto _ : State) {
+        CodeGen Gen(Checked.SemanInfo, Options);
+        benchmark::DoNotOptimize(Gen.doIt(*Checked.Program.Mod));
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_CodeGen)->ArgsProduct({ { 100, 1000, 10000 }, { 0 } })->ArgsProduct({ { 1000 }, { 1, 2, 3 } })
+    ->Unit(benchmark::kMillisecond);
+
+// Arg: -O level. What the level buys at run time: a compute-bound program is
+// compiled at that level and its main run in the lazy JIT. Only the call is
+// timed, which includes compiling its two functions (about a millisecond).
+static void BM_CodeGenRuntime(benchmark::State& State) {
+    CheckedProgram Checked(generateComputeProgram(5, 12));
+    const auto Options = makeOptions(State.range(0));
+    for (auto _ : State) {
+        CodeGen Gen(Checked.SemanInfo, Options);
+        Gen.doIt(*Checked.Program.Mod);
+        std::string Error;
+        const auto Result = runJIT(Gen.takeModule(), "main", Error);
+        if (!Result) {
+            State.SkipWithError(Error.c_str());
+            break;
+        }
+        State.SetIterationTime(std::chrono::duration<double>(Result->FirstCallTime).count());
+    }
+}
+BENCHMARK(BM_CodeGenRuntime)->DenseRange(0, 3)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_CodeGenFixture(benchmark::State& State) {
+    CheckedProgram Checked{ std::string(CodeGenFixture) };
+    for (auto _ : State) {
+        CodeGen Gen(Checked.SemanInfo);
+        benchmark::DoNotOptimize(Gen.doIt(*Checked.Program.Mod));
+    }
+}
+BENCHMARK(BM_CodeGenFixture);
+
+// Parse, Seman and CodeGen at -O0, up to 100k functions.
+static void BM_FrontendToIR(benchmark::State& State) {
+    const auto Code = generateCodeGenProgram(static_cast<std::size_t>(State.range(0)));
+    for (auto _ : State) {
+        CheckedProgram Checked(Code);
+        CodeGen Gen(Checked.SemanInfo);
+        benchmark::DoNotOptimize(Gen.doIt(*Checked.Program.Mod));
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_FrontendToIR)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+// A 10000 function library compiled from root f<N>, lazily: only the bodies
+// reachable from the root are parsed, checked and emitted. Compare with
+// BM_FrontendToIR/10000, which does the whole library.
+static void BM_LazyLibraryToIR(benchmark::State& State) {
+    const auto Code = generateCodeGenProgram(10000);
+    const std::vector<std::string> Roots = { std::format("f{}", State.range(0)) };
+    std::size_t NumReached = 0;
+    for (auto _ : State) {
+        ParsedProgram Program(Code, { .LazyBodies = true });
+        Seman SemanInfo(*Program.Mod->TyContext, Program.Reporter);
+        SemanInfo.visit(*Program.Mod);
+        const auto Reached = SemanInfo.visitReachable(*Program.Mod, Roots);
+        CodeGen Gen(SemanInfo);
+        benchmark::DoNotOptimize(Gen.doIt(Reached));
+        NumReached = Reached.size();
+    }
+    State.counters["reached"] = static_cast<double>(NumReached);
+}
+BENCHMARK(BM_LazyLibraryToIR)->Arg(10)->Arg(100)->Arg(1000)->Arg(9999)->Unit(benchmark::kMillisecond);
+
+// An edit to the body of one function in the middle of an N function program,
+// undone and redone each iteration. Only that body is parsed, checked and
+// emitted again; compare with BM_FrontendToIR/N, which redoes everything.
+static void BM_IncrementalRebuild(benchmark::State& State) {
+    const auto NumFunctions = static_cast<std::size_t>(State.range(0));
+    const auto Code = generateCodeGenProgram(NumFunctions);
+    auto Edited = Code;
+    const auto Start = Edited.find(std::format("fn f{}(", NumFunctions / 2));
+    Edited.insert(Edited.find("{\n", Start) + 2, "    let edited: i32 = 1;\n");
+    IncrementalCompiler Compiler("bench.unl");
+    ErrorReporter Reporter;
+    Compiler.rebuild(Code, Reporter);
+    bool UseEdited = true;
+    for (auto _ : State) {
+        benchmark::DoNotOptimize(Compiler.rebuild(UseEdited ? Edited : Code, Reporter));
+        UseEdited = !UseEdited;
+    }
+    State.counters["reused"] = Compiler.getStats().Reused;
+    State.counters["recompiled"] = Compiler.getStats().Recompiled;
+}
+BENCHMARK(BM_IncrementalRebuild)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+// Args: number of functions, worker threads.
+static void BM_ParallelCodeGen(benchmark::State& State) {
+    CheckedProgram Checked(generateCodeGenProgram(static_cast<std::size_t>(State.range(0))));
+    const auto Options = makeOptions(2);
+    const auto Path = (std::filesystem::temp_directory_path() / "unl-bench-parallel.a").string();
+    for (auto _ : State) {
+        benchmark::DoNotOptimize(emitParallel(*Checked.Program.Mod, Checked.SemanInfo, Options,
+                                              static_cast<unsigned>(State.range(1)), Path));
+    }
+    std::filesystem::remove(Path);
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_ParallelCodeGen)->ArgsProduct({ { 2000 }, { 1, 2, 4, 8 } })->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Time to the first result of main: CodeGen then the lazy JIT, against
+// CodeGen then an object file (BM_AOTObject), which still needs linking.
+static void BM_JITFirstResult(benchmark::State& State) {
+    CheckedProgram Checked(generateCodeGenProgram(static_cast<std::size_t>(State.range(0))));
+    double SetupTime = 0;
+    double FirstCallTime = 0;
+    for (auto _ : State) {
+        CodeGen Gen(Checked.SemanInfo);
+        Gen.doIt(*Checked.Program.Mod);
+        std::string Error;
+        const auto Result = runJIT(Gen.takeModule(), "main", Error);
+        if (!Result) {
+            State.SkipWithError(Error.c_str());
+            break;
+        }
+        SetupTime += std::chrono::duration<double>(Result->SetupTime).count();
+        FirstCallTime += std::chrono::duration<double>(Result->FirstCallTime).count();
+    }
+    State.counters["setup"] = benchmark::Counter(SetupTime, benchmark::Counter::kAvgIterations);
+    State.counters["first_call"] = benchmark::Counter(FirstCallTime, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_JITFirstResult)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void BM_AOTObject(benchmark::State& State) {
+    CheckedProgram Checked(generateCodeGenProgram(static_cast<std::size_t>(State.range(0))));
+    for (auto _ : State) {
+        CodeGen Gen(Checked.SemanInfo);
+        Gen.doIt(*Checked.Program.Mod);
+        llvm::SmallVector<char, 0> Object;
+        llvm::raw_svector_ostream Out(Object);
+        std::string Error;
+        benchmark::DoNotOptimize(Gen.emitToStream(Out, OutputKind::Object, Error));
+    }
+}
+BENCHMARK(BM_AOTObject)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+// Every lookup after the first hits the cache and skips the whole pipeline.
+static void BM_CompilationCacheHit(benchmark::State& State) {
+    const auto Directory = std::filesystem::temp_directory_path() / "unl-bench-cache";
+    CompilationCache Cache(Directory, 1 << 30);
+    SourceFile Source(generateCodeGenProgram(static_cast<std::size_t>(State.range(0))), "bench.unl");
+    ErrorReporter Reporter;
+    const auto Options = makeOptions(2);
+    compileCached(Cache, Source, Options, OutputKind::Object, Reporter);
+    for (auto _ : State) {
+        benchmark::DoNotOptimize(compileCached(Cache, Source, Options, OutputKind::Object, Reporter));
+    }
+    std::filesystem::remove_all(Directory);
+}
+BENCHMARK(BM_CompilationCacheHit)->Arg(1000)->Unit(benchmark::kMillisecond);
\ No newline at end of file
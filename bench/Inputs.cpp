@@ -0,0 +1,112 @@
+#include "Inputs.h"
+#include "Parser/Parser.h"
+#include "ProgramGenerator.h"
+#include <format>
+
+const std::string_view FrontendFixture = R"(struct Point { x: i32, y: i32 }
+struct Node { value: i32, next: *Node, points: [Point, 4] }
+fn length(node: *Node): i32 {
+    let count: i32 = 1;
+    while (count < 100 && count != 50) {
+        count = count + 1 * 2 - 3 / 1;
+    }
+    return count;
+}
+fn first(node: Node): i32 {
+    let point: Point = node.points[1];
+    let values: [i32, 3] = {1, 2, 3};
+    if (point.x >= values[1] || !(point.y <= 2)) {
+        return point.x as i32;
+    } else {
+        return -point.y;
+    }
+}
+fn swap(a: *i32, b: *i32): bool {
+    let tmp: i32 = *a;
+    *a = *b;
+    *b = tmp;
+    return *a == *b;
+}
+fn main(): i32 {
+    let n: Node;
+    let x: i32 = first(n);
+    let y: i32 = 2;
+    let same: bool = swap(&x, &y);
+    return length(&n) + x;
+}
+)";
+
+const std::string_view CodeGenFixture = R"(fn select(a: i32, b: i32, c: bool): i32 {
+    let r: i32 = a;
+    if (c && true) { r = -b; } else { r = a; }
+    return r;
+}
+fn loop(a: i32, b: bool): i32 {
+    let x: i32 = a;
+    while (b) {
+        let y: i32 = select(x, a, b);
+        if (b || false) { x = -y; } else { b = false; }
+    }
+    return x;
+}
+fn main(): i32 {
+    let x: i32 = 1;
+    let y: i32 = loop(x, false);
+    return select(x, y, true);
+}
+)";
+
+std::string generateFrontendProgram(std::size_t NumFunctions) {
+    GeneratorOptions Options;
+    Options.NumFunctions = static_cast<std::uint32_t>(NumFunctions);
+    Options.NumStructs = static_cast<std::uint32_t>(NumFunctions / 10 + 1);
+    return generateProgram(Options);
+}
+
+std::string generateCodeGenProgram(std::size_t NumFunctions) {
+    GeneratorOptions Options;
+    Options.NumFunctions = static_cast<std::uint32_t>(NumFunctions);
+    Options.CodeGenSubset = true;
+    return generateProgram(Options);
+}
+
+std::string generateComputeProgram(std::size_t Depth, std::size_t Width) {
+    std::string Code = R"(fn mix(x: i32, flip: bool): i32 {
+    let r: i32 = x;
+    if (flip) { r = -x; }
+    return r;
+}
+fn main(): i32 {
+    let x: i32 = 1;
+)";
+    const auto Indent = [](std::size_t Level) { return std::string(4 * (Level + 1), ' '); };
+    for (std::size_t Loop = 0; Loop < Depth; Loop++) {
+        for (std::size_t Bit = 0; Bit < Width; Bit++) {
+            Code += std::format("    let r{}_{}: bool = true;\n", Loop, Bit);
+        }
+    }
+    for (std::size_t Loop = 0; Loop < Depth; Loop++) {
+        const auto Outer = Indent(Loop);
+        const auto Inner = Indent(Loop + 1);
+        if (Loop > 0) {
+            for (std::size_t Bit = 0; Bit < Width; Bit++) {
+                Code += std::format("{}r{}_{} = true;\n", Outer, Loop, Bit);
+            }
+        }
+        Code += std::format("{}while (r{}_0) {{\n", Outer, Loop);
+        for (std::size_t Bit = 0; Bit + 1 < Width; Bit++) {
+            Code += std::format("{}r{}_{} = r{}_{};\n", Inner, Loop, Bit, Loop, Bit + 1);
+        }
+        Code += std::format("{}r{}_{} = false;\n", Inner, Loop, Width - 1);
+    }
+    Code += std::format("{}x = mix(x, r{}_0 || r0_0);\n", Indent(Depth), Depth - 1);
+    for (std::size_t Loop = Depth; Loop-- > 0;) {
+        Code += Indent(Loop) + "}\n";
+    }
+    Code += "    return x;\n}\n";
+    return Code;
+}
+
+ParsedProgram::ParsedProgram(std::string Code, const ParseOptions& Options) : Source(std::move(Code), "bench.unl") {
+    Mod = Parser::parseSourceFile(Source, Reporter, std::make_shared<TypeContext>(), Options);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "AST/Module.h"
+#include "Parser/Parser.h"
+#include "Utils/ErrorReporter.h"
+#include "Utils/SourceFile.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Hand-written program using every construct the parser accepts.
+extern const std::string_view FrontendFixture;
+// Hand-written program restricted to what CodeGen can compile.
+extern const std::string_view CodeGenFixture;
+
+// Programs of NumFunctions functions from the program generator with a fixed
+// seed. Frontend programs use the whole language, CodeGen programs only what
+// CodeGen can compile.
+std::string generateFrontendProgram(std::size_t NumFunctions);
+std::string generateCodeGenProgram(std::size_t NumFunctions);
+// A CodeGen program whose main runs long enough to time: Depth nested loops
+// that each run Width times around a call. CodeGen compiles no comparisons, so
+// every loop is bounded by a shift register of Width bools.
+std::string generateComputeProgram(std::size_t Depth, std::size_t Width);
+
+// A source file together with its parsed module. Not movable, since the
+// module refers to the source file.
+struct ParsedProgram {
+    ParsedProgram(std::string Code, const ParseOptions& Options = {});
+    ParsedProgram(const ParsedProgram&) = delete;
+    ParsedProgram& operator=(const ParsedProgram&) = delete;
+
+    SourceFile Source;
+    ErrorReporter Reporter;
+    std::unique_ptr<Module> Mod;
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "Inputs.h"
+#include "Parser/Lexer.h"
+#include "Parser/TokenBuffer.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+    void lexAll(benchmark::State& State, std::string_view Code) {
+        std::int64_t NumTokens = 0;
+        for (auto _ : State) {
+            Lexer Lex(Code);
+            while (true) {
+                const auto Tok = Lex.nextToken();
+                benchmark::DoNotOptimize(Tok);
+                NumTokens++;
+                if (Tok.is(TokenKind::Eof)) {
+                    break;
+                }
+            }
+        }
+        State.SetItemsProcessed(NumTokens);
+        State.SetBytesProcessed(static_cast<std::int64_t>(State.iterations() * Code.size()));
+    }
+
+    // Keywords and identifiers of keyword length, which all go through the
+    // keyword lookup.
+    std::string keywordHeavy(std::size_t Repeat) {
+        std::string Code;
+        for (std::size_t Index = 0; Index < Repeat; Index++) {
+            Code += "fn let while if else return struct as true false lets iff whiles fnord ";
+        }
+        return Code;
+    }
+}
+
+static void BM_LexFixture(benchmark::State& State) {
+    lexAll(State, FrontendFixture);
+}
+BENCHMARK(BM_LexFixture);
+
+static void BM_LexKeywords(benchmark::State& State) {
+    lexAll(State, keywordHeavy(1000));
+}
+BENCHMARK(BM_LexKeywords);
+
+static void BM_LexGenerated(benchmark::State& State) {
+    lexAll(State, generateFrontendProgram(static_cast<std::size_t>(State.range(0))));
+}
+BENCHMARK(BM_LexGenerated)->RangeMultiplier(10)->Range(10, 10000);
+
+// Pre-lexing into a TokenBuffer, to compare with BM_LexGenerated.
+static void BM_TokenBuffer(benchmark::State& State) {
+    const auto Code = generateFrontendProgram(static_cast<std::size_t>(State.range(0)));
+    std::int64_t NumTokens = 0;
+    for (auto _ : State) {
+        TokenBuffer Tokens(Code);
+        benchmark::DoNotOptimize(Tokens.size());
+        NumTokens += static_cast<std::int64_t>(Tokens.size());
+    }
+    State.SetItemsProcessed(NumTokens);
+    State.SetBytesProcessed(static_cast<std::int64_t>(State.iterations() * Code.size()));
+}
+BENCHMARK(BM_TokenBuffer)->RangeMultiplier(10)->Range(10, 10000);
\ No newline at end of file
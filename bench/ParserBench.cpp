@@ -0,0 +1,124 @@
+#include "Inputs.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <pthread.h>
+#include <string>
+
+namespace {
+    // Items are AST nodes, so items/s is the parser's node rate.
+    void parseAll(benchmark::State& State, const std::string& Code, bool PreLex, unsigned Threads = 1) {
+        std::int64_t NumNodes = 0;
+        for (auto _ : State) {
+            ParsedProgram Program(Code, { .PreLex = PreLex, .Threads = Threads });
+            NumNodes += static_cast<std::int64_t>(Program.Mod->getNumNodes());
+        }
+        State.SetItemsProcessed(NumNodes);
+        State.SetBytesProcessed(static_cast<std::int64_t>(State.iterations() * Code.size()));
+    }
+
+    // Statements of Length operands joined by operators of every precedence.
+    std::string arithmeticChains(std::size_t Length) {
+        constexpr std::string_view Ops[] = { "+", "*", "-", "/", "<", "==", "&&", "||", ">=", "!=" };
+        std::string Code = "fn f(a: i32): i32 {\n";
+        for (int Stmt = 0; Stmt < 100; Stmt++) {
+            Code += "    a = a";
+            for (std::size_t Index = 1; Index < Length; Index++) {
+                Code += std::format(" {} a", Ops[Index % std::size(Ops)]);
+            }
+            Code += ";\n";
+        }
+        return Code + "    return a;\n}\n";
+    }
+
+    // Calls nested Depth deep in each other's arguments.
+    std::string nestedCalls(std::size_t Depth) {
+        std::string Code = "fn f(a: i32, b: i32): i32 {\n";
+        for (int Stmt = 0; Stmt < 100; Stmt++) {
+            Code += "    a = ";
+            for (std::size_t Index = 0; Index < Depth; Index++) {
+                Code += "f(a, ";
+            }
+            Code += "b" + std::string(Depth, ')') + ";\n";
+        }
+        return Code + "    return a;\n}\n";
+    }
+
+    // A parenthesised operand nested Depth deep.
+    std::string nestedParens(std::size_t Depth) {
+        return "fn f(a: i32): i32 {\n    return " + std::string(Depth, '(') + "a" + std::string(Depth, ')') + ";\n}\n";
+    }
+
+    // Parses Code on a thread whose stack is painted with a pattern first, and returns how many bytes of the
+    // stack it used: everything from the first overwritten byte up.
+    std::size_t parseStackUsage(const std::string& Code) {
+        constexpr std::size_t StackSize = 16 << 20;
+        constexpr unsigned char Paint = 0xa5;
+        const auto Stack = static_cast<unsigned char*>(std::aligned_alloc(4096, StackSize));
+        std::fill_n(Stack, StackSize, Paint);
+        pthread_attr_t Attr;
+        pthread_attr_init(&Attr);
+        pthread_attr_setstack(&Attr, Stack, StackSize);
+        pthread_t Thread;
+        const auto Parse = [](void* Arg) -> void* {
+            ParsedProgram Program(*static_cast<const std::string*>(Arg));
+            return nullptr;
+        };
+        pthread_create(&Thread, &Attr, Parse, const_cast<std::string*>(&Code));
+        pthread_join(Thread, nullptr);
+        pthread_attr_destroy(&Attr);
+        const auto Untouched = static_cast<std::size_t>(std::find_if(Stack, Stack + StackSize, [](auto Byte) { return Byte != Paint; }) - Stack);
+        std::free(Stack);
+        return StackSize - Untouched;
+    }
+}
+
+static void BM_ParseFixture(benchmark::State& State) {
+    parseAll(State, std::string(FrontendFixture), false);
+}
+BENCHMARK(BM_ParseFixture);
+
+static void BM_ParseGenerated(benchmark::State& State) {
+    parseAll(State, generateFrontendProgram(static_cast<std::size_t>(State.range(0))), false);
+}
+BENCHMARK(BM_ParseGenerated)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_ParseGeneratedPreLex(benchmark::State& State) {
+    parseAll(State, generateFrontendProgram(static_cast<std::size_t>(State.range(0))), true);
+}
+BENCHMARK(BM_ParseGeneratedPreLex)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_ParseArithmeticChains(benchmark::State& State) {
+    parseAll(State, arithmeticChains(static_cast<std::size_t>(State.range(0))), false);
+}
+BENCHMARK(BM_ParseArithmeticChains)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_ParseNestedCalls(benchmark::State& State) {
+    parseAll(State, nestedCalls(static_cast<std::size_t>(State.range(0))), false);
+}
+BENCHMARK(BM_ParseNestedCalls)->Arg(10)->Arg(100);
+
+// Arg: nesting depth. Not a timing: the stack a parse of Arg nested parentheses takes, the growth per level
+// over a single level, and from those the deepest nesting that fits a 256 KiB thread stack.
+static void BM_ParenNestingStack(benchmark::State& State) {
+    const auto Depth = static_cast<std::size_t>(State.range(0));
+    const auto Base = parseStackUsage(nestedParens(1));
+    std::size_t Used = 0;
+    for (auto _ : State) {
+        Used = parseStackUsage(nestedParens(Depth));
+    }
+    const auto PerLevel = static_cast<double>(Used - Base) / static_cast<double>(Depth - 1);
+    State.counters["stack_bytes"] = static_cast<double>(Used);
+    State.counters["bytes_per_level"] = PerLevel;
+    State.counters["max_depth_256KiB"] = std::floor((256 * 1024 - static_cast<double>(Base)) / PerLevel) + 1;
+}
+BENCHMARK(BM_ParenNestingStack)->Arg(100)->Arg(1000)->Iterations(1);
+
+// Arguments are the function count and the number of parser threads.
+static void BM_ParseGeneratedParallel(benchmark::State& State) {
+    const auto Code = generateFrontendProgram(static_cast<std::size_t>(State.range(0)));
+    parseAll(State, Code, true, static_cast<unsigned>(State.range(1)));
+}
+BENCHMARK(BM_ParseGeneratedParallel)->ArgsProduct({ { 1000, 10000 }, { 1, 2, 4, 8 } })->UseRealTime();
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "Inputs.h"
+#include "AST/TypeContext.h"
+#include "Seman/NameResolver.h"
+#include "Seman/Seman.h"
+#include "Seman/TypeCheck.h"
+#include "Seman/Validator.h"
+#include <benchmark/benchmark.h>
+#include <optional>
+
+namespace {
+    enum class Pass { Validate, ResolveNames, TypeCheck };
+
+    // Times one Seman pass on a freshly parsed program; parsing and the
+    // passes it depends on run with the timer paused.
+    void runPass(benchmark::State& State, Pass Timed) {
+        const auto Code = generateFrontendProgram(static_cast<std::size_t>(State.range(0)));
+        std::optional<ParsedProgram> Program;
+        std::optional<Seman> SemanInfo;
+        for (auto _ : State) {
+            State.PauseTiming();
+            SemanInfo.reset();
+            Program.emplace(Code);
+            auto& TyContext = *Program->Mod->TyContext;
+            SemanInfo.emplace(TyContext, Program->Reporter);
+            Validator Validate(*SemanInfo, TyContext);
+            if (Timed == Pass::Validate) {
+                State.ResumeTiming();
+            }
+            Validate.doVisit(*Program->Mod);
+            if (Timed == Pass::Validate) {
+                continue;
+            }
+            NameResolver Resolver(*SemanInfo, Validate.getStructTypes());
+            if (Timed == Pass::ResolveNames) {
+                State.ResumeTiming();
+            }
+            Program->Mod->accept(Resolver);
+            if (Timed == Pass::ResolveNames) {
+                continue;
+            }
+            TypeCheck TyCheck(*SemanInfo);
+            State.ResumeTiming();
+            TyCheck.doVisit(*Program->Mod);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+}
+
+static void BM_Validator(benchmark::State& State) {
+    runPass(State, Pass::Validate);
+}
+BENCHMARK(BM_Validator)->RangeMultiplier(10)->Range(100, 10000);
+
+static void BM_NameResolver(benchmark::State& State) {
+    runPass(State, Pass::ResolveNames);
+}
+BENCHMARK(BM_NameResolver)->RangeMultiplier(10)->Range(100, 10000);
+
+static void BM_TypeCheck(benchmark::State& State) {
+    runPass(State, Pass::TypeCheck);
+}
+BENCHMARK(BM_TypeCheck)->RangeMultiplier(10)->Range(100, 10000);
+
+// All passes through Seman::visit on the hand-written fixture.
+static void BM_SemanFixture(benchmark::State& State) {
+    std::optional<ParsedProgram> Program;
+    for (auto _ : State) {
+        State.PauseTiming();
+        Program.emplace(std::string(FrontendFixture));
+        State.ResumeTiming();
+        Seman SemanInfo(*Program->Mod->TyContext, Program->Reporter);
+        SemanInfo.visit(*Program->Mod);
+    }
+}
+BENCHMARK(BM_SemanFixture);
+
+// Parse and Seman together, to plot frontend time against program size.
+static void BM_ParseAndCheck(benchmark::State& State) {
+    const auto Code = generateFrontendProgram(static_cast<std::size_t>(State.range(0)));
+    for (auto _ : State) {
+        ParsedProgram Program(Code);
+        Seman SemanInfo(*Program.Mod->TyContext, Program.Reporter);
+        SemanInfo.visit(*Program.Mod);
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+    State.SetBytesProcessed(static_cast<std::int64_t>(State.iterations() * Code.size()));
+    State.SetComplexityN(State.range(0));
+}
+BENCHMARK(BM_ParseAndCheck)->RangeMultiplier(4)->Range(16, 4096)->Complexity()->Unit(benchmark::kMillisecond);
\ No newline at end of file
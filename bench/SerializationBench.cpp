@@ -0,0 +1,78 @@
+#include "Inputs.h"
+#include "AST/TypeContext.h"
+#include "CodeGen/CodeGen.h"
+#include "Seman/Seman.h"
+#include "Serialization/ModuleReader.h"
+#include "Serialization/ModuleWriter.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+    // Parses and checks Code, writes it to a module file in the temp directory and returns the path.
+    std::string writeProgramModule(const std::string& Code, const std::string& Name) {
+        ParsedProgram Program(Code);
+        Seman SemanInfo(*Program.Mod->TyContext, Program.Reporter);
+        SemanInfo.visit(*Program.Mod);
+        const auto Path = (std::filesystem::temp_directory_path() / Name).string();
+        writeModuleFile(*Program.Mod, SemanInfo, Path);
+        return Path;
+    }
+}
+
+static void BM_WriteModule(benchmark::State& State) {
+    ParsedProgram Program(generateFrontendProgram(static_cast<std::size_t>(State.range(0))));
+    Seman SemanInfo(*Program.Mod->TyContext, Program.Reporter);
+    SemanInfo.visit(*Program.Mod);
+    std::size_t Size = 0;
+    for (auto _ : State) {
+        Size = writeModule(*Program.Mod, SemanInfo).size();
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+    State.counters["bytes"] = static_cast<double>(Size);
+    State.counters["source_bytes"] = static_cast<double>(Program.Source.getSourceCode().size());
+}
+BENCHMARK(BM_WriteModule)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+
+// Arg 0 reads every body, arg 1 only the declarations. Compare with BM_ParseAndCheck, which produces the
+// same module and Seman results from source.
+static void BM_ReadModule(benchmark::State& State) {
+    const auto NumFunctions = static_cast<std::size_t>(State.range(0));
+    const auto Path = writeProgramModule(generateFrontendProgram(NumFunctions), "unl-bench-read.unlm");
+    for (auto _ : State) {
+        std::string Error;
+        const auto Reader = ModuleReader::open(Path, Error);
+        const auto TyContext = std::make_shared<TypeContext>();
+        ErrorReporter Reporter;
+        Seman SemanInfo(*TyContext, Reporter);
+        benchmark::DoNotOptimize(Reader->read(TyContext, SemanInfo, State.range(1) != 0));
+    }
+    std::filesystem::remove(Path);
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_ReadModule)->ArgsProduct({ { 100, 1000, 10000 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+// BM_LazyLibraryToIR from a module file instead of source: only the bodies reachable from root f<N> are read,
+// and none is parsed or checked.
+static void BM_LazyModuleToIR(benchmark::State& State) {
+    const auto Path = writeProgramModule(generateCodeGenProgram(10000), "unl-bench-lazy.unlm");
+    const std::vector<std::string> Roots = { std::format("f{}", State.range(0)) };
+    std::size_t NumReached = 0;
+    for (auto _ : State) {
+        std::string Error;
+        const auto Reader = ModuleReader::open(Path, Error);
+        const auto TyContext = std::make_shared<TypeContext>();
+        ErrorReporter Reporter;
+        Seman SemanInfo(*TyContext, Reporter);
+        const auto Mod = Reader->read(TyContext, SemanInfo);
+        const auto Reached = SemanInfo.visitReachable(*Mod, Roots);
+        CodeGen Gen(SemanInfo);
+        benchmark::DoNotOptimize(Gen.doIt(Reached));
+        NumReached = Reached.size();
+    }
+    std::filesystem::remove(Path);
+    State.counters["reached"] = static_cast<double>(NumReached);
+}
+BENCHMARK(BM_LazyModuleToIR)->Arg(10)->Arg(100)->Arg(1000)->Arg(9999)->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "AST/TypeContext.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+    // Requests an array, a pointer to it and a function over both for each
+    // of State.range(0) indices. The array size is the index, so all three
+    // are distinct per index and a fresh context creates every one of them.
+    void uniqueTypes(benchmark::State& State, TypeContext& Context) {
+        const auto Count = State.range(0);
+        const auto& Builtins = Context.getBuiltinTypes();
+        for (std::int64_t Index = 0; Index < Count; Index++) {
+            const auto Element = Builtins[static_cast<std::size_t>(Index) % Builtins.size()];
+            const auto Array = Context.getArrayType(Element, static_cast<std::uint64_t>(Index + 1));
+            const auto Pointer = Context.getPointerType(Array);
+            const std::vector<const Type*> Params = { Pointer, Array };
+            benchmark::DoNotOptimize(Context.getFunctionType(Element, Params));
+        }
+    }
+}
+
+static void BM_TypeContextUniquing(benchmark::State& State) {
+    for (auto _ : State) {
+        TypeContext Context;
+        uniqueTypes(State, Context);
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0) * 3);
+}
+BENCHMARK(BM_TypeContextUniquing)->Arg(1000)->Arg(100000);
+
+// Every request is a hit.
+static void BM_TypeContextLookup(benchmark::State& State) {
+    TypeContext Context;
+    uniqueTypes(State, Context);
+    for (auto _ : State) {
+        uniqueTypes(State, Context);
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0) * 3);
+}
+BENCHMARK(BM_TypeContextLookup)->Arg(1000)->Arg(100000);
\ No newline at end of file
@@ -1,5 +1,5 @@
 #pragma once
-#include <memory>
+#include <span>
 
 class AstConstVisitor;
 class AstVisitor;
@@ -7,14 +7,19 @@ class AstVisitor;
 class AstBase {
 public:
     AstBase() = default;
-    virtual ~AstBase() = default;
     AstBase(const AstBase&) = delete;
     AstBase& operator=(const AstBase&) = delete;
     AstBase(const AstBase&&) = delete;
     AstBase& operator=(const AstBase&&) = delete;
     virtual void accept(AstConstVisitor& Visitor) const = 0;
     virtual void accept(AstVisitor& Visitor) = 0;
+protected:
+    // Nodes live in the module's Arena and are never deleted through a base pointer.
+    ~AstBase() = default;
 };
 
 template <typename T>
-using AstPtr = std::unique_ptr<T>;
\ No newline at end of file
+using AstPtr = T*;
+
+template <typename T>
+using AstList = std::span<AstPtr<T>>;
\ No newline at end of file
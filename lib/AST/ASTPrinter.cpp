@@ -86,7 +86,9 @@ void AstPrinter::visit(const FunctionDecl& Node) {
     }
     printNodeInfo("Identifier", Node.getIdentifier().getName(), "ParamNames", ParamNames);
     Scoper.AtLastChild = true;
-    Node.getBody().accept(*this);
+    if (Node.isBodyParsed()) {
+        Node.getBody().accept(*this);
+    }
 }
 
 void AstPrinter::visit(const IfStmt& Node) {
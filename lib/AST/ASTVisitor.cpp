@@ -82,7 +82,9 @@ void AstConstVisitor::visit(const AssignStmt& Node) {
 }
 
 void AstConstVisitor::visit(const FunctionDecl& Node) {
-    Node.getBody().accept(*this);
+    if (Node.isBodyParsed()) {
+        Node.getBody().accept(*this);
+    }
 }
 
 void AstConstVisitor::visit(const StructDecl& Node) {
@@ -177,7 +179,9 @@ void AstVisitor::visit(AssignStmt& Node) {
 }
 
 void AstVisitor::visit(FunctionDecl& Node) {
-    Node.getBody().accept(*this);
+    if (Node.isBodyParsed()) {
+        Node.getBody().accept(*this);
+    }
 }
 
 void AstVisitor::visit(StructDecl& Node) {
@@ -2,7 +2,7 @@
 #include "ASTBase.h"
 #include "Stmt.h"
 #include "Type.h"
-#include <vector>
+#include <span>
 
 class Declaration : public AstBase {
 };
@@ -11,36 +11,46 @@ class Declaration : public AstBase {
 class FunctionDecl final : public Declaration, public Nameable {
 public:
     struct Param : Nameable {
-        Param(IdentifierSymbol Identifier, const Type* ParamType) : Nameable(std::move(Identifier)), ParamType(ParamType) {}
+        Param(IdentifierSymbol Identifier, std::uint32_t NameID, const Type* ParamType) :
+            Nameable(std::move(Identifier), NameID), ParamType(ParamType) {}
         const Type* ParamType;
     };
-    FunctionDecl(IdentifierSymbol Identifier, const Type* RetType, std::vector<Param> Params, AstPtr<Statement> Body) :
-        Nameable(std::move(Identifier)), RetType(RetType), Params(std::move(Params)), Body(std::move(Body)) {}
+    FunctionDecl(IdentifierSymbol Identifier, std::uint32_t NameID, const Type* RetType, std::span<Param> Params, AstPtr<Statement> Body) :
+        Nameable(std::move(Identifier), NameID), RetType(RetType), Params(Params), Body(std::move(Body)) {}
+    // A function whose body was skipped by a lazy parse; BodyStart is the location of its opening brace.
+    FunctionDecl(IdentifierSymbol Identifier, std::uint32_t NameID, const Type* RetType, std::span<Param> Params, SourceLoc BodyStart) :
+        Nameable(std::move(Identifier), NameID), RetType(RetType), Params(Params), Body(nullptr), BodyStart(BodyStart) {}
     [[nodiscard]] Statement& getBody() const {
         return *Body;
     }
+    bool isBodyParsed() const { return Body != nullptr; }
+    SourceLoc getBodyStart() const { return BodyStart; }
+    void setBody(AstPtr<Statement> NewBody) { Body = NewBody; }
     const Type& getRetType() const { return *RetType; }
     auto& getParams() const { return Params; }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
     const Type* RetType;
-    std::vector<Param> Params;
+    std::span<Param> Params;
     AstPtr<Statement> Body;
+    SourceLoc BodyStart;
 };
 
 struct StructDeclField : Nameable {
-    StructDeclField(IdentifierSymbol Identifier, const Type* FieldType) : Nameable(std::move(Identifier)), FieldType(FieldType) {}
+    StructDeclField(IdentifierSymbol Identifier, std::uint32_t NameID, const Type* FieldType) :
+        Nameable(std::move(Identifier), NameID), FieldType(FieldType) {}
     const Type* FieldType;
 };
 
 class StructDecl final : public Declaration, public Nameable {
 public:
 
-    StructDecl(IdentifierSymbol Identifier, std::vector<StructDeclField> Fields) : Nameable(std::move(Identifier)), Fields(std::move(Fields)) {}
+    StructDecl(IdentifierSymbol Identifier, std::uint32_t NameID, std::span<StructDeclField> Fields) :
+        Nameable(std::move(Identifier), NameID), Fields(Fields) {}
     auto& getFields() const { return Fields; }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
-    std::vector<StructDeclField> Fields;
+    std::span<StructDeclField> Fields;
 };
\ No newline at end of file
@@ -4,7 +4,6 @@
 #include "Utils/Literal.h"
 #include "Identifier.h"
 #include "Parser/TokenKind.h"
-#include <vector>
 
 class Expression : public AstBase {
 public:
@@ -80,9 +79,9 @@ private:
 
 class FunctionCallExpr : public Expression {
 public:
-    FunctionCallExpr(AstPtr<Expression> Function, std::vector<AstPtr<Expression>> Args, SourceLoc EndLoc) :
+    FunctionCallExpr(AstPtr<Expression> Function, AstList<Expression> Args, SourceLoc EndLoc) :
         Function(std::move(Function)),
-        Args(std::move(Args)), EndLoc(EndLoc) {
+        Args(Args), EndLoc(EndLoc) {
     }
 
     auto& getFunction() const { return *Function; }
@@ -96,7 +95,7 @@ public:
 
 private:
     AstPtr<Expression> Function;
-    std::vector<AstPtr<Expression>> Args;
+    AstList<Expression> Args;
     SourceLoc EndLoc;
 };
 
@@ -178,8 +177,8 @@ private:
 
 class CompoundExpr : public Expression {
 public:
-    CompoundExpr(std::vector<AstPtr<Expression>> Exprs, SourceLoc StartLoc, SourceLoc EndLoc) :
-        Exprs(std::move(Exprs)), StartLoc(StartLoc), EndLoc(EndLoc) {}
+    CompoundExpr(AstList<Expression> Exprs, SourceLoc StartLoc, SourceLoc EndLoc) :
+        Exprs(Exprs), StartLoc(StartLoc), EndLoc(EndLoc) {}
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
     auto& getExprs() const { return Exprs; }
@@ -187,6 +186,6 @@ public:
         return { StartLoc, EndLoc };
     }
 private:
-    std::vector<AstPtr<Expression>> Exprs;
+    AstList<Expression> Exprs;
     SourceLoc StartLoc, EndLoc;
 };
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "Identifier.h"
+
+const IdentifierInfo* IdentifierTable::get(std::string_view Name) {
+    {
+        std::shared_lock Lock(Mutex);
+        if (const auto Iter = Lookup.find(Name); Iter != Lookup.end()) {
+            return Iter->second;
+        }
+    }
+    std::unique_lock Lock(Mutex);
+    // Another thread may have added the name since the shared lock was released.
+    if (const auto Iter = Lookup.find(Name); Iter != Lookup.end()) {
+        return Iter->second;
+    }
+    const auto& Info = Infos.emplace_back(std::string(Name), static_cast<std::uint32_t>(Infos.size()));
+    Lookup.emplace(Info.getName(), &Info);
+    return &Info;
+}
+
+size_t IdentifierTable::size() const {
+    std::shared_lock Lock(Mutex);
+    return Infos.size();
+}
@@ -1,23 +1,58 @@
 #pragma once
 
 #include "Utils/SourceLoc.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
-class IdentifierSymbol {
+// One entry per distinct spelling. Entries are never moved, so two names
+// are equal exactly when their IdentifierInfo pointers (or IDs) are.
+class IdentifierInfo {
 public:
-    IdentifierSymbol(std::string Name, const SourceRange &Range) : Name(std::move(Name)), Range(Range) {}
+    IdentifierInfo(std::string Name, std::uint32_t ID) : Name(std::move(Name)), ID(ID) {}
     const std::string& getName() const { return Name; }
-    const SourceRange& getRange() const { return Range; }
+    std::uint32_t getID() const { return ID; }
 private:
     std::string Name;
+    std::uint32_t ID;
+};
+
+// Safe to use from several threads; lookups of known names only take a shared lock.
+class IdentifierTable {
+public:
+    const IdentifierInfo* get(std::string_view Name);
+    size_t size() const;
+private:
+    mutable std::shared_mutex Mutex;
+    std::deque<IdentifierInfo> Infos;
+    std::unordered_map<std::string_view, const IdentifierInfo*> Lookup;
+};
+
+class IdentifierSymbol {
+public:
+    IdentifierSymbol(const IdentifierInfo* Info, const SourceRange &Range) : Info(Info), Range(Range) {}
+    const std::string& getName() const { return Info->getName(); }
+    const IdentifierInfo* getInfo() const { return Info; }
+    std::uint32_t getID() const { return Info->getID(); }
+    const SourceRange& getRange() const { return Range; }
+private:
+    const IdentifierInfo* Info;
     SourceRange Range;
 };
 
+// NameID is dense within a TypeContext (see TypeContext::allocateNameID), so
+// semantic results about a declaration can live in a DenseTable.
 class Nameable {
 public:
-    explicit Nameable(IdentifierSymbol Identifier) : Identifier(std::move(Identifier)) {}
+    Nameable(IdentifierSymbol Identifier, std::uint32_t NameID) : Identifier(std::move(Identifier)), NameID(NameID) {}
     const auto& getIdentifier() const { return Identifier; }
     const auto& getName() const { return Identifier.getName(); }
+    std::uint32_t getNameID() const { return NameID; }
 private:
     IdentifierSymbol Identifier;
+    std::uint32_t NameID;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Module.h"
 #include "ASTVisitor.h"
+#include <numeric>
 
 void Module::accept(AstConstVisitor& Visitor) const {
     Visitor.visit(*this);
@@ -8,3 +9,13 @@ void Module::accept(AstConstVisitor& Visitor) const {
 void Module::accept(AstVisitor& Visitor) {
     Visitor.visit(*this);
 }
+
+std::size_t Module::getNumNodes() const {
+    return std::accumulate(NodeArenas.begin(), NodeArenas.end(), std::size_t(0),
+                           [](std::size_t Sum, const auto& NodeArena) { return Sum + NodeArena->getNumObjects(); });
+}
+
+std::size_t Module::getBytesAllocated() const {
+    return std::accumulate(NodeArenas.begin(), NodeArenas.end(), std::size_t(0),
+                           [](std::size_t Sum, const auto& NodeArena) { return Sum + NodeArena->getBytesAllocated(); });
+}
@@ -2,21 +2,41 @@
 #include "ASTBase.h"
 #include "Decl.h"
 #include "TypeContext.h"
+#include "Utils/Arena.h"
 #include <vector>
 #include <memory>
+#include <string>
 
 class SourceFile;
 
+// Supplies the function bodies of a module that was not parsed from source (see ModuleReader).
+class ExternalBodySource {
+public:
+    virtual ~ExternalBodySource() = default;
+    // Gives Function its body with names resolved and types checked, as Seman would leave it. Returns false,
+    // leaving Function without a body and the reason in getError, if the body cannot be read.
+    virtual bool loadBody(FunctionDecl& Function) = 0;
+    virtual const std::string& getError() const = 0;
+};
+
 class Module : public AstBase {
 public:
-    Module(std::vector<AstPtr<Declaration>> Declarations, std::shared_ptr<TypeContext> TyContext, SourceFile& Source) :
-        Declarations(std::move(Declarations)), TyContext(std::move(TyContext)), Source(Source) {}
+    // A parallel parse leaves the nodes spread over one arena per worker thread.
+    Module(std::vector<AstPtr<Declaration>> Declarations, std::shared_ptr<TypeContext> TyContext, SourceFile& Source,
+           std::vector<std::unique_ptr<Arena>> NodeArenas) :
+        NodeArenas(std::move(NodeArenas)), Declarations(std::move(Declarations)), TyContext(std::move(TyContext)), Source(Source) {}
     const auto& getDeclarations() const { return Declarations; }
     SourceFile& getSourceFile() const { return Source; }
+    const auto& getArenas() const { return NodeArenas; }
+    std::size_t getNumNodes() const;
+    std::size_t getBytesAllocated() const;
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 public:
+    std::vector<std::unique_ptr<Arena>> NodeArenas;
     std::vector<AstPtr<Declaration>> Declarations;
     std::shared_ptr<TypeContext> TyContext;
     SourceFile& Source;
+    // Set for a module whose bodies are read on demand; Seman::visitReachable asks it instead of the parser.
+    ExternalBodySource* BodySource = nullptr;
 };
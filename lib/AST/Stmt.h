@@ -16,8 +16,8 @@ public:
     }
 
     [[nodiscard]] Expression& getCondition() const { return *Condition; }
-    [[nodiscard]] Statement* getTrueBlock() const { return TrueBlock.get(); }
-    [[nodiscard]] Statement* getFalseBlock() const { return FalseBlock.get(); }
+    [[nodiscard]] Statement* getTrueBlock() const { return TrueBlock; }
+    [[nodiscard]] Statement* getFalseBlock() const { return FalseBlock; }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
@@ -27,10 +27,10 @@ private:
 
 class LetStmt : public Statement, public Nameable {
 public:
-    LetStmt(IdentifierSymbol Identifier, const TypeInfo &TyInfo, AstPtr<Expression> Value) :
-        Nameable(std::move(Identifier)), TyInfo(TyInfo), Value(std::move(Value)) {}
+    LetStmt(IdentifierSymbol Identifier, std::uint32_t NameID, const TypeInfo &TyInfo, AstPtr<Expression> Value) :
+        Nameable(std::move(Identifier), NameID), TyInfo(TyInfo), Value(std::move(Value)) {}
     const auto& getTypeInfo() const { return TyInfo; }
-    Expression* getValue() const { return Value.get();  }
+    Expression* getValue() const { return Value;  }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
@@ -65,14 +65,14 @@ private:
 
 class CompoundStmt : public Statement {
 public:
-    explicit CompoundStmt(std::vector<AstPtr<Statement>> Body) : Body(std::move(Body)) {
+    explicit CompoundStmt(AstList<Statement> Body) : Body(Body) {
     }
 
     [[nodiscard]] auto& getBody() const { return Body; }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
-    std::vector<AstPtr<Statement>> Body;
+    AstList<Statement> Body;
 };
 
 class ReturnStmt : public Statement {
@@ -80,7 +80,7 @@ public:
     explicit ReturnStmt(AstPtr<Expression> Value) : Value(std::move(Value)) {
     }
 
-    [[nodiscard]] Expression* getValue() const { return Value.get(); }
+    [[nodiscard]] Expression* getValue() const { return Value; }
     void accept(AstConstVisitor& Visitor) const override;
     void accept(AstVisitor& Visitor) override;
 private:
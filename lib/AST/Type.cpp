@@ -13,7 +13,7 @@ bool Type::isVoidType() const {
     return Context.getVoidType() == this;
 }
 
-Type::Type(TypeContext& Context) : Context(Context) {
+Type::Type(TypeContext& Context) : Context(Context), ID(Context.allocateTypeID()) {
 }
 
 void PrimitiveType::accept(TypeVisitor& Visitor) const {
@@ -60,10 +60,10 @@ void UnresolvedType::accept(TypeVisitor& Visitor) const {
     Visitor.visit(*this);
 }
 
-const StructDeclField* StructType::getField(const std::string& FieldName) const {
+const StructDeclField* StructType::getField(const IdentifierInfo* FieldName) const {
     const auto& Fields = Decl.getFields();
     const auto Iter = std::ranges::find_if(Fields, [&](auto &Field) {
-        return Field.getName() == FieldName;
+        return Field.getIdentifier().getInfo() == FieldName;
     });
     if (Iter != Fields.end()) {
         return &*Iter;
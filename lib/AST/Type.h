@@ -48,9 +48,14 @@ public:
     virtual TypeTag getTag() const = 0;
     virtual void accept(TypeVisitor& Visitor) const = 0;
 
+    // Dense within the owning TypeContext; keys per-type side tables.
+    std::uint32_t getID() const { return ID; }
+
 protected:
     Type(TypeContext& Context);
     TypeContext& Context;
+private:
+    std::uint32_t ID;
 };
 
 class PrimitiveType : public Type {
@@ -161,6 +166,8 @@ public:
     void accept(TypeVisitor& Visitor) const override;
 
 private:
+    // Moves the type to an earlier use of its name (see TypeContext::createUnresolvedType).
+    friend class TypeContext;
     IdentifierSymbol Identifier;
 };
 
@@ -174,7 +181,7 @@ public:
     }
 
     std::string toString() const override { return Name; }
-    const StructDeclField* getField(const std::string& FieldName) const;
+    const StructDeclField* getField(const IdentifierInfo* FieldName) const;
     std::string getName() const { return Name; }
     const auto& getDecl() const { return Decl; }
     TypeTag getTag() const override { return TypeTag::Struct; }
@@ -1,5 +1,12 @@
 #include "TypeContext.h"
-#include <ranges>
+#include <algorithm>
+#include <functional>
+
+namespace {
+    size_t hashCombine(size_t Seed, size_t Value) {
+        return Seed ^ (Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2));
+    }
+}
 
 TypeContext::TypeContext() :
     I8Ty(*this, "i8", 8, true),
@@ -19,47 +26,69 @@ TypeContext::TypeContext() :
 }
 
 const PointerType* TypeContext::getPointerType(const Type* ElementType) {
-    const auto Iter = std::ranges::find_if(PointerTypes, [&](const auto& Ptr) {
-        return Ptr->getElementType() == ElementType;
-    });
-    if (Iter != PointerTypes.end()) {
-        return Iter->get();
+    std::lock_guard Lock(TypesMutex);
+    auto& Entry = PointerTypeMap[ElementType];
+    if (Entry == nullptr) {
+        PointerTypes.push_back(std::make_unique<PointerType>(*this, ElementType));
+        Entry = PointerTypes.back().get();
     }
-    auto Ptr = std::make_unique<PointerType>(*this, ElementType);
-    PointerTypes.push_back(std::move(Ptr));
-    return PointerTypes.back().get();
+    return Entry;
 }
 
 const ArrayType* TypeContext::getArrayType(const Type* ElementType, std::uint64_t Size) {
-    const auto Iter = std::ranges::find_if(ArrayTypes, [&](const auto& Ptr) {
-        return Ptr->getElementType() == ElementType && Ptr->getSize() == Size;
-    });
-    if (Iter != ArrayTypes.end()) {
-        return Iter->get();
+    std::lock_guard Lock(TypesMutex);
+    auto& Entry = ArrayTypeMap[{ ElementType, Size }];
+    if (Entry == nullptr) {
+        ArrayTypes.push_back(std::make_unique<ArrayType>(*this, ElementType, Size));
+        Entry = ArrayTypes.back().get();
     }
-    auto Ptr = std::make_unique<ArrayType>(*this, ElementType, Size);
-    ArrayTypes.push_back(std::move(Ptr));
-    return ArrayTypes.back().get();
+    return Entry;
 }
 
 const FunctionType* TypeContext::getFunctionType(const Type* ReturnType, const std::vector<const Type*>& ParamTypes) {
-    const auto Iter = std::ranges::find_if(FunctionTypes, [&](const auto& Ptr) {
-        return Ptr->getReturnType() == ReturnType && Ptr->getParamTypes() == ParamTypes;
-    });
-    if (Iter != FunctionTypes.end()) {
-        return Iter->get();
+    std::lock_guard Lock(TypesMutex);
+    const auto Iter = FunctionTypeMap.find({ ReturnType, ParamTypes });
+    if (Iter != FunctionTypeMap.end()) {
+        return Iter->second;
     }
-    auto Ptr = std::make_unique<FunctionType>(*this, ReturnType, ParamTypes);
-    FunctionTypes.push_back(std::move(Ptr));
-    return FunctionTypes.back().get();
+    FunctionTypes.push_back(std::make_unique<FunctionType>(*this, ReturnType, ParamTypes));
+    const auto Ty = FunctionTypes.back().get();
+    FunctionTypeMap.emplace(FunctionKey{ ReturnType, Ty->getParamTypes() }, Ty);
+    return Ty;
 }
 
 const UnresolvedType* TypeContext::createUnresolvedType(IdentifierSymbol Identifier) {
-    UnresolvedTypes.push_back(std::make_unique<UnresolvedType>(*this, std::move(Identifier)));
-    return UnresolvedTypes.back().get();
+    std::lock_guard Lock(TypesMutex);
+    auto& Entry = UnresolvedTypeMap[Identifier.getInfo()];
+    if (Entry == nullptr) {
+        UnresolvedTypes.push_back(std::make_unique<UnresolvedType>(*this, std::move(Identifier)));
+        Entry = UnresolvedTypes.back().get();
+    } else if (Identifier.getRange().Start.Offset < Entry->Identifier.getRange().Start.Offset) {
+        // A parallel parse creates the type from whichever use a worker reaches first; keeping the earliest
+        // use makes "type not found" point where a serial parse would.
+        Entry->Identifier = std::move(Identifier);
+    }
+    return Entry;
 }
 
 const StructType* TypeContext::createStructType(std::string Name, const StructDecl& Decl) {
+    std::lock_guard Lock(TypesMutex);
     StructTypes.push_back(std::make_unique<StructType>(*this, std::move(Name), Decl));
     return StructTypes.back().get();
 }
+
+size_t TypeContext::ArrayKeyHash::operator()(const ArrayKey& Key) const {
+    return hashCombine(std::hash<const Type*>{}(Key.first), std::hash<std::uint64_t>{}(Key.second));
+}
+
+size_t TypeContext::FunctionKeyHash::operator()(const FunctionKey& Key) const {
+    auto Hash = std::hash<const Type*>{}(Key.ReturnType);
+    for (const auto Param : Key.ParamTypes) {
+        Hash = hashCombine(Hash, std::hash<const Type*>{}(Param));
+    }
+    return Hash;
+}
+
+bool TypeContext::FunctionKeyEqual::operator()(const FunctionKey& Lhs, const FunctionKey& Rhs) const {
+    return Lhs.ReturnType == Rhs.ReturnType && std::ranges::equal(Lhs.ParamTypes, Rhs.ParamTypes);
+}
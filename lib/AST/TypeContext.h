@@ -1,14 +1,23 @@
 #pragma once
 #include "Type.h"
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
 
+// The type factories and ID allocators may be called from several threads at
+// once (see Parser::parseSourceFile). IDs stay dense, but which thread gets
+// which ID depends on scheduling.
 class TypeContext {
 public:
     TypeContext();
     const PointerType* getPointerType(const Type* ElementType);
     const ArrayType* getArrayType(const Type* ElementType, std::uint64_t Size);
     const FunctionType* getFunctionType(const Type* ReturnType, const std::vector<const Type*>& ParamTypes);
+    // One type per name, located at the earliest use in the source.
     const UnresolvedType* createUnresolvedType(IdentifierSymbol Identifier);
     const StructType* createStructType(std::string Name, const StructDecl& Decl);
     auto& getBuiltinTypes() const { return BuiltinTypes; }
@@ -16,7 +25,37 @@ public:
     const Type* getI32Type() const { return &I32Ty; }
     const Type* getF32Type() const { return &F32Ty; }
     const Type* getVoidType() const { return &VoidTy; }
+    IdentifierTable& getIdentifiers() { return Identifiers; }
+    std::uint32_t allocateTypeID() { return NumTypes.fetch_add(1, std::memory_order_relaxed); }
+    std::uint32_t allocateNameID() { return NumNames.fetch_add(1, std::memory_order_relaxed); }
+    // Reserves Count consecutive NameIDs and returns the first.
+    std::uint32_t allocateNameIDs(std::uint32_t Count) { return NumNames.fetch_add(Count, std::memory_order_relaxed); }
+    std::uint32_t getNumTypes() const { return NumTypes.load(std::memory_order_relaxed); }
+    std::uint32_t getNumNames() const { return NumNames.load(std::memory_order_relaxed); }
 private:
+    using ArrayKey = std::pair<const Type*, std::uint64_t>;
+
+    struct FunctionKey {
+        const Type* ReturnType;
+        std::span<const Type* const> ParamTypes;
+    };
+
+    struct ArrayKeyHash {
+        size_t operator()(const ArrayKey& Key) const;
+    };
+
+    struct FunctionKeyHash {
+        size_t operator()(const FunctionKey& Key) const;
+    };
+
+    struct FunctionKeyEqual {
+        bool operator()(const FunctionKey& Lhs, const FunctionKey& Rhs) const;
+    };
+
+    IdentifierTable Identifiers;
+    // Declared before the builtin types, whose constructors draw IDs from it.
+    std::atomic<std::uint32_t> NumTypes = 0;
+    std::atomic<std::uint32_t> NumNames = 0;
     IntegerType I8Ty, I16Ty, I32Ty, I64Ty;
     IntegerType U8Ty, U16Ty, U32Ty, U64Ty;
     FloatingPointType F32Ty, F64Ty;
@@ -27,4 +66,11 @@ private:
     std::vector<std::unique_ptr<StructType>> StructTypes;
     std::vector<std::unique_ptr<UnresolvedType>> UnresolvedTypes;
     std::vector<const Type*> BuiltinTypes;
+    // Guards the owning vectors and uniquing tables below.
+    std::mutex TypesMutex;
+    // Uniquing tables; the keys of FunctionTypeMap view the ParamTypes of the type they map to.
+    std::unordered_map<const Type*, const PointerType*> PointerTypeMap;
+    std::unordered_map<ArrayKey, const ArrayType*, ArrayKeyHash> ArrayTypeMap;
+    std::unordered_map<FunctionKey, const FunctionType*, FunctionKeyHash, FunctionKeyEqual> FunctionTypeMap;
+    std::unordered_map<const IdentifierInfo*, UnresolvedType*> UnresolvedTypeMap;
 };
@@ -1,34 +1,177 @@
 #include "CodeGen.h"
+#include "Optimizer.h"
 #include "Seman/Seman.h"
+#include "Utils/TimeReport.h"
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <algorithm>
+
+namespace {
+    // Finds locals whose address is taken with '&'; those have to stay in memory.
+    class AddressTakenCollector : public AstConstVisitor {
+    public:
+        explicit AddressTakenCollector(DenseTable<const NamedExpr*>& AddressTaken) : AddressTaken(AddressTaken) {}
+        void visit(const UnaryOpExpr& Node) override {
+            const bool IsAddressOf = Node.getKind() == TokenKind::Amp;
+            AddressOfDepth += IsAddressOf;
+            AstConstVisitor::visit(Node);
+            AddressOfDepth -= IsAddressOf;
+        }
+        void visit(const NamedExpr& Node) override {
+            if (AddressOfDepth > 0) {
+                AddressTaken[Node.getRefedName()->getNameID()] = &Node;
+            }
+        }
+    private:
+        DenseTable<const NamedExpr*>& AddressTaken;
+        int AddressOfDepth = 0;
+    };
+}
+
+CodeGen::CodeGen(Seman& SemanInfo, const CodeGenOptions& Options) : SemanInfo(SemanInfo), Options(Options) {
+    // Every module this CodeGen starts shares one TargetMachine.
+    std::string Error;
+    Target = createTargetMachine(Options, Error);
+    if (Target == nullptr) {
+        llvm::errs() << Error << "\n";
+    }
+}
 
 CodeGen::~CodeGen() = default;
 
-void CodeGen::doIt(const Module& Module) {
+bool CodeGen::doIt(const Module& Module) {
+    {
+        TimeScope Scope("codegen");
+        startModule();
+        AstConstVisitor::visit(Module);
+    }
+    return finishModule();
+}
+
+bool CodeGen::doIt(std::span<const FunctionDecl* const> Functions) {
+    {
+        TimeScope Scope("codegen");
+        startModule();
+        for (const auto Function : Functions) {
+            visit(*Function);
+        }
+    }
+    return finishModule();
+}
+
+bool CodeGen::update(std::span<const FunctionDecl* const> Changed, std::span<const std::string> Removed) {
+    {
+        TimeScope Scope("codegen");
+        if (TheModule == nullptr) {
+            startModule();
+        }
+        // Drop the old bodies first, so the functions they called lose those uses.
+        for (const auto Function : Changed) {
+            if (const auto Func = TheModule->getFunction(Function->getName())) {
+                Func->deleteBody();
+            }
+        }
+        for (const auto& Name : Removed) {
+            if (const auto Func = TheModule->getFunction(Name)) {
+                Func->deleteBody();
+            }
+        }
+        // Callers of a removed or retyped function refer to it by name, so they were re-analyzed and are in
+        // Changed; anything still using one means the caller was missed.
+        for (const auto& Name : Removed) {
+            if (const auto Func = TheModule->getFunction(Name)) {
+                if (!Func->use_empty()) {
+                    return false;
+                }
+                Func->eraseFromParent();
+            }
+        }
+        // A function emitted again gets a fresh replacement, so its local names come out as in a full build.
+        for (const auto Function : Changed) {
+            const auto Func = TheModule->getFunction(Function->getName());
+            if (Func == nullptr) {
+                continue;
+            }
+            const auto FuncTy = llvm::cast<llvm::FunctionType>(TyEmitter->emit(*SemanInfo.getType(*Function)));
+            if (Func->getFunctionType() == FuncTy) {
+                const auto NewFunc = llvm::Function::Create(FuncTy, llvm::GlobalValue::ExternalLinkage);
+                TheModule->getFunctionList().insert(Func->getIterator(), NewFunc);
+                Func->replaceAllUsesWith(NewFunc);
+                NewFunc->takeName(Func);
+                NameValues[Function->getNameID()] = NewFunc;
+            } else if (!Func->use_empty()) {
+                return false;
+            }
+            Func->eraseFromParent();
+        }
+        for (const auto Function : Changed) {
+            visit(*Function);
+        }
+    }
+    // The functions kept were verified when they were emitted.
+    TimeScope Scope("verify");
+    return std::ranges::none_of(Changed, [this](const FunctionDecl* Function) {
+        return verifyFunction(*llvm::cast<llvm::Function>(NameValues.lookup(Function->getNameID())), &llvm::outs());
+    });
+}
+
+void CodeGen::startModule() {
     Context = std::make_unique<llvm::LLVMContext>();
     TheModule = std::make_unique<llvm::Module>("", *Context);
+    if (Target != nullptr) {
+        TheModule->setTargetTriple(Target->getTargetTriple().str());
+        TheModule->setDataLayout(Target->createDataLayout());
+    }
     TyEmitter = std::make_unique<TypeEmitter>(*Context, SemanInfo);
     Builder = std::make_unique<llvm::IRBuilder<>>(*Context);
-    AstConstVisitor::visit(Module);
-    TheModule->dump();
-    verifyModule(*TheModule, &llvm::outs());
+    NameValues = {};
+}
+
+bool CodeGen::finishModule() {
+    {
+        TimeScope Scope("verify");
+        if (verifyModule(*TheModule, &llvm::outs())) {
+            return false;
+        }
+    }
+    optimizeModule(*TheModule, Options.Opt, Target.get());
+    return true;
 }
 
 void CodeGen::visit(const FunctionDecl& FunctionDecl) {
+    TraceScope Span("codegen function", FunctionDecl.getName());
     const auto Func = emitFunctionProto(FunctionDecl);
+    // A body a lazy parse never needed stays an external declaration.
+    if (!FunctionDecl.isBodyParsed()) {
+        return;
+    }
     const auto Block = llvm::BasicBlock::Create(*Context, "entry", Func);
     Builder->SetInsertPoint(Block);
+    const auto Undef = llvm::UndefValue::get(Builder->getInt32Ty());
+    AllocaInsertPt = new llvm::BitCastInst(Undef, Builder->getInt32Ty(), "allocapt", Block);
+    if (Options.EmitSSA) {
+        SSA.reset();
+        sealBlock(Block);
+        AddressTakenCollector Collector(AddressTaken);
+        FunctionDecl.getBody().accept(Collector);
+    }
     for (const auto [Arg, Param] : zip_equal(Func->args(), FunctionDecl.getParams())) {
         Arg.setName(Param.getName());
         const auto ArgTy = Arg.getType();
-        const auto Alloca = Builder->CreateAlloca(ArgTy);
-        Alloca->setName(Param.getName() + ".addr");
+        if (isSSACandidate(Param, ArgTy)) {
+            SSA.declareVariable(Param.getNameID(), ArgTy);
+            SSA.writeVariable(Param.getNameID(), Block, &Arg);
+            continue;
+        }
+        const auto Alloca = createEntryAlloca(ArgTy, Param.getName() + ".addr");
         Builder->CreateStore(&Arg, Alloca);
-        NameValues[&Param] = Alloca;
+        NameValues[Param.getNameID()] = Alloca;
     }
 
     llvmFunction = Func;
@@ -39,24 +182,27 @@ void CodeGen::visit(const FunctionDecl& FunctionDecl) {
     if (LastBlock.empty() || !LastBlock.back().isTerminator()) {
         Builder->CreateUnreachable();
     }
+    AllocaInsertPt->eraseFromParent();
+    AllocaInsertPt = nullptr;
 }
 
 void CodeGen::visit(const LetStmt& LetStmt) {
     const auto LetTy = SemanInfo.getType(LetStmt);
     const auto Ty = TyEmitter->emit(*LetTy);
-    const auto Alloca = Builder->CreateAlloca(Ty);
-    Alloca->getType()->dump();
-
-    const auto X = llvm::cast<llvm::GetElementPtrInst>(Builder->CreateGEP(Ty, Alloca, { Builder->getInt32(0) }));
-    X->getSourceElementType()->dump();
-    X->getResultElementType()->dump();
+    if (isSSACandidate(LetStmt, Ty)) {
+        SSA.declareVariable(LetStmt.getNameID(), Ty);
+        const auto Value = LetStmt.getValue();
+        const auto Init = Value != nullptr ? emitRValue(*Value) : llvm::UndefValue::get(Ty);
+        SSA.writeVariable(LetStmt.getNameID(), Builder->GetInsertBlock(), Init);
+        return;
+    }
+    const auto Alloca = createEntryAlloca(Ty, LetStmt.getName());
 
-    Alloca->setName(LetStmt.getName());
     if (const auto Value = LetStmt.getValue()) {
         const auto Init = emitRValue(*Value);
         Builder->CreateStore(Init, Alloca);
     }
-    NameValues[&LetStmt] = Alloca;
+    NameValues[LetStmt.getNameID()] = Alloca;
 }
 
 void CodeGen::visit(const LiteralExpr& LiteralExpr) {
@@ -70,10 +216,13 @@ void CodeGen::visit(const LiteralExpr& LiteralExpr) {
 
 void CodeGen::visit(const NamedExpr& NamedExpr) {
     const auto RefName = NamedExpr.getRefedName();
-    if (!NameValues.contains(RefName)) {
-        NameValues[RefName] = emitFunctionProto(*static_cast<const FunctionDecl*>(RefName));
+    if (SSA.isVariable(RefName->getNameID())) {
+        return returnValue(SSA.readVariable(RefName->getNameID(), Builder->GetInsertBlock()));
+    }
+    if (const auto Value = NameValues.lookup(RefName->getNameID())) {
+        return returnValue(Value);
     }
-    return returnValue(NameValues[RefName]);
+    return returnValue(emitFunctionProto(*static_cast<const FunctionDecl*>(RefName)));
 }
 
 void CodeGen::visit(const BinaryOpExpr& BinaryOpExpr) {
@@ -90,12 +239,14 @@ void CodeGen::visit(const ReturnStmt& ReturnStmt) {
     Builder->CreateRet(Ret);
 
     const auto Block = emitBlock("return.after");
+    sealBlock(Block);
     Builder->SetInsertPoint(Block);
 }
 
 void CodeGen::visit(const IfStmt& IfStmt) {
     const auto CondBlock = emitBlock("if.cond");
     Builder->CreateBr(CondBlock);
+    sealBlock(CondBlock);
 
     Builder->SetInsertPoint(CondBlock);
     const auto Cond = emitRValue(IfStmt.getCondition());
@@ -104,6 +255,8 @@ void CodeGen::visit(const IfStmt& IfStmt) {
     auto ElseBlock = emitBlock("if.else");
 
     Builder->CreateCondBr(Cond, ThenBlock, ElseBlock);
+    sealBlock(ThenBlock);
+    sealBlock(ElseBlock);
     Builder->SetInsertPoint(ThenBlock);
     IfStmt.getTrueBlock()->accept(*this);
 
@@ -124,6 +277,7 @@ void CodeGen::visit(const IfStmt& IfStmt) {
     Builder->CreateBr(FinishBlock);
     Builder->SetInsertPoint(ElseBlock);
     Builder->CreateBr(FinishBlock);
+    sealBlock(FinishBlock);
 
     Builder->SetInsertPoint(FinishBlock);
 }
@@ -135,27 +289,27 @@ void CodeGen::visit(const WhileStmt& WhileStmt) {
     Builder->SetInsertPoint(CondBlock);
 
     const auto Cond = emitRValue(WhileStmt.getCondition());
-    auto CondBr = Builder->CreateCondBr(Cond, CondBlock, CondBlock);
-
     const auto BodyBlock = emitBlock("while.body");
+    // Inserted after the body so the blocks stay in source order.
+    const auto FinishBlock = llvm::BasicBlock::Create(*Context, "while.finish");
+    Builder->CreateCondBr(Cond, BodyBlock, FinishBlock);
+    sealBlock(BodyBlock);
+
     Builder->SetInsertPoint(BodyBlock);
     WhileStmt.getBody().accept(*this);
     Builder->CreateBr(CondBlock);
+    sealBlock(CondBlock);
 
-    const auto FinishBlock = emitBlock("while.finish");
+    FinishBlock->insertInto(llvmFunction);
+    sealBlock(FinishBlock);
     Builder->SetInsertPoint(FinishBlock);
-
-    CondBr->setSuccessor(0, BodyBlock);
-    CondBr->setSuccessor(1, FinishBlock);
 }
 
 void CodeGen::visit(const FunctionCallExpr& FunctionCallExpr) {
     auto Func = llvm::cast<llvm::Function>(emitRValue(FunctionCallExpr.getFunction()));
     std::vector<llvm::Value*> Args;
     for (const auto &Arg : FunctionCallExpr.getArgs()) {
-        const auto Value = emitRValue(*Arg);
-        Value->getType()->dump();
-        Args.push_back(Value);
+        Args.push_back(emitRValue(*Arg));
     }
     returnValue(Builder->CreateCall(Func, Args));
 }
@@ -179,6 +333,14 @@ void CodeGen::visit(const UnaryOpExpr& UnaryOpExpr) {
 }
 
 void CodeGen::visit(const AssignStmt& AssignStmt) {
+    if (const auto Named = dynamic_cast<const NamedExpr*>(&AssignStmt.getLeft())) {
+        const auto Var = Named->getRefedName()->getNameID();
+        if (SSA.isVariable(Var)) {
+            const auto Rhs = emitRValue(AssignStmt.getRight());
+            SSA.writeVariable(Var, Builder->GetInsertBlock(), Rhs);
+            return;
+        }
+    }
     const auto Lhs = emitLValue(AssignStmt.getLeft());
     const auto Rhs = emitRValue(AssignStmt.getRight());
     Builder->CreateStore(Rhs, Lhs);
@@ -206,40 +368,89 @@ void CodeGen::visit(const CastExpr& CastExpr) {
     return returnValue(Res);
 }
 
+bool CodeGen::emitFile(const std::string& Path, OutputKind Kind) const {
+    std::string Error;
+    if (!emitModule(*TheModule, Target.get(), Kind, Path, Error)) {
+        llvm::errs() << Error << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool CodeGen::emitToStream(llvm::raw_pwrite_stream& Out, OutputKind Kind, std::string& Error) const {
+    return emitModule(*TheModule, Target.get(), Kind, Out, Error);
+}
+
+bool CodeGen::emitOptimizedFile(const std::string& Path, OutputKind Kind) const {
+    const auto Copy = llvm::CloneModule(*TheModule);
+    optimizeModule(*Copy, Options.Opt, Target.get());
+    std::string Error;
+    if (!emitModule(*Copy, Target.get(), Kind, Path, Error)) {
+        llvm::errs() << Error << "\n";
+        return false;
+    }
+    return true;
+}
+
+llvm::orc::ThreadSafeModule CodeGen::takeModule() {
+    return { std::move(TheModule), std::move(Context) };
+}
+
 llvm::Function* CodeGen::emitFunctionProto(const FunctionDecl& FunctionDecl) {
-    if (!NameValues.contains(&FunctionDecl)) {
+    auto& Entry = NameValues[FunctionDecl.getNameID()];
+    if (Entry == nullptr) {
         const auto FuncTy = llvm::cast<llvm::FunctionType>(TyEmitter->emit(*SemanInfo.getType(FunctionDecl)));
-        const auto Func = llvm::Function::Create(FuncTy, llvm::GlobalValue::ExternalLinkage, FunctionDecl.getName(), TheModule.get());
-        NameValues[&FunctionDecl] = Func;
+        Entry = llvm::Function::Create(FuncTy, llvm::GlobalValue::ExternalLinkage, FunctionDecl.getName(), TheModule.get());
     }
-    return llvm::cast<llvm::Function>(NameValues[&FunctionDecl]);
+    return llvm::cast<llvm::Function>(Entry);
 }
 
 llvm::BasicBlock* CodeGen::emitBlock(std::string_view Name = "") const {
     return llvm::BasicBlock::Create(*Context, Name, llvmFunction);
 }
 
+llvm::AllocaInst* CodeGen::createEntryAlloca(llvm::Type* Ty, const llvm::Twine& Name) {
+    const auto AddrSpace = TheModule->getDataLayout().getAllocaAddrSpace();
+    return new llvm::AllocaInst(Ty, AddrSpace, Name, AllocaInsertPt);
+}
+
+bool CodeGen::isSSACandidate(const Nameable& Name, llvm::Type* Ty) const {
+    if (!Options.EmitSSA || AddressTaken.lookup(Name.getNameID()) != nullptr) {
+        return false;
+    }
+    return Ty->isIntegerTy() || Ty->isFloatingPointTy();
+}
+
+void CodeGen::sealBlock(llvm::BasicBlock* Block) {
+    if (Options.EmitSSA) {
+        SSA.sealBlock(Block);
+    }
+}
+
 llvm::Value* CodeGen::emitLogicalAnd(const Expression& Left, const Expression& Right) {
     auto LhsBlock = emitBlock("land.lhs");
     Builder->CreateBr(LhsBlock);
+    sealBlock(LhsBlock);
 
     Builder->SetInsertPoint(LhsBlock);
     const auto Lft = emitRValue(Left);
 
     LhsBlock = Builder->GetInsertBlock();
 
-    Builder->SetInsertPoint(emitBlock("land.rhs"));
+    // Branch before emitting the right side so its entry block can be sealed
+    // first; the finish block is inserted once the right side is complete.
+    const auto RhsEntry = emitBlock("land.rhs");
+    const auto Finish = llvm::BasicBlock::Create(*Context, "land.finish");
+    Builder->CreateCondBr(Lft, RhsEntry, Finish);
+    sealBlock(RhsEntry);
+
+    Builder->SetInsertPoint(RhsEntry);
     const auto Rgt = emitRValue(Right);
 
     const auto RhsBlock = Builder->GetInsertBlock();
-
-    auto Finish = emitBlock("land.finish");
-
-    Builder->SetInsertPoint(LhsBlock);
-    Builder->CreateCondBr(Lft, RhsBlock, Finish);
-
-    Builder->SetInsertPoint(RhsBlock);
     Builder->CreateBr(Finish);
+    Finish->insertInto(llvmFunction);
+    sealBlock(Finish);
 
     Builder->SetInsertPoint(Finish);
     auto Phi = Builder->CreatePHI(Builder->getInt1Ty(), 2);
@@ -251,24 +462,27 @@ llvm::Value* CodeGen::emitLogicalAnd(const Expression& Left, const Expression& R
 llvm::Value* CodeGen::emitLogicalOr(const Expression& Left, const Expression& Right) {
     auto LhsBlock = emitBlock("lor.lhs");
     Builder->CreateBr(LhsBlock);
+    sealBlock(LhsBlock);
 
     Builder->SetInsertPoint(LhsBlock);
     const auto Lft = emitRValue(Left);
 
     LhsBlock = Builder->GetInsertBlock();
 
-    Builder->SetInsertPoint(emitBlock("lor.lrhs"));
+    // Branch before emitting the right side so its entry block can be sealed
+    // first; the finish block is inserted once the right side is complete.
+    const auto RhsEntry = emitBlock("lor.lrhs");
+    const auto Finish = llvm::BasicBlock::Create(*Context, "lor.finish");
+    Builder->CreateCondBr(Lft, Finish, RhsEntry);
+    sealBlock(RhsEntry);
+
+    Builder->SetInsertPoint(RhsEntry);
     const auto Rgt = emitRValue(Right);
 
     const auto RhsBlock = Builder->GetInsertBlock();
-
-    auto Finish = emitBlock("lor.finish");
-
-    Builder->SetInsertPoint(LhsBlock);
-    Builder->CreateCondBr(Lft, Finish, RhsBlock);
-
-    Builder->SetInsertPoint(RhsBlock);
     Builder->CreateBr(Finish);
+    Finish->insertInto(llvmFunction);
+    sealBlock(Finish);
 
     Builder->SetInsertPoint(Finish);
     auto Phi = Builder->CreatePHI(Builder->getInt1Ty(), 2);
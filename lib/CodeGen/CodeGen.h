@@ -1,18 +1,29 @@
 #pragma once
+#include "CodeGenOptions.h"
+#include "ObjectEmitter.h"
+#include "SSABuilder.h"
 #include "TypeEmitter.h"
 #include "AST/ASTVisitor.h"
+#include "Utils/DenseTable.h"
 #include "Utils/VisitorBase.h"
 #include <llvm/IR/IRBuilder.h>
 #include <memory>
-#include <map>
+#include <span>
 #include <string_view>
 
 namespace llvm {
+    class AllocaInst;
+    class Instruction;
+    class Twine;
     class Value;
     class LLVMContext;
     class Module;
+    class TargetMachine;
     class Function;
     class BasicBlock;
+    namespace orc {
+        class ThreadSafeModule;
+    }
 };
 
 class Seman;
@@ -20,9 +31,24 @@ struct BuilderTy;
 
 class CodeGen : public VisitorBase<CodeGen, const AstBase, llvm::Value*>, public AstConstVisitor {
 public:
-    CodeGen(Seman& SemanInfo) : SemanInfo(SemanInfo) {}
+    CodeGen(Seman& SemanInfo, const CodeGenOptions& Options = {});
     ~CodeGen() override;
-    void doIt(const Module& Module);
+    // Both return false if the generated module fails verification.
+    bool doIt(const Module& Module);
+    // Emits bodies for Functions only; anything else they call is declared.
+    bool doIt(std::span<const FunctionDecl* const> Functions);
+    // Brings the module up to date after an incremental re-analysis (see IncrementalCompiler): the functions
+    // named in Removed are dropped and those in Changed re-emitted in place, keeping every other function.
+    // The module is left unoptimized, so it can be updated again; emitOptimizedFile writes an optimized copy.
+    // Returns false if a function in use elsewhere changed type or a re-emitted function fails verification.
+    bool update(std::span<const FunctionDecl* const> Changed, std::span<const std::string> Removed);
+    llvm::Module* getModule() const { return TheModule.get(); }
+    // Writes the module built by doIt; diagnostics go to stderr.
+    bool emitFile(const std::string& Path, OutputKind Kind) const;
+    bool emitToStream(llvm::raw_pwrite_stream& Out, OutputKind Kind, std::string& Error) const;
+    bool emitOptimizedFile(const std::string& Path, OutputKind Kind) const;
+    // Hands the module and its context over, e.g. to runJIT.
+    llvm::orc::ThreadSafeModule takeModule();
 
     void visit(const FunctionDecl&) override;
     void visit(const LetStmt&) override;
@@ -38,8 +64,13 @@ public:
     void visit(const CastExpr&) override;
 
 private:
+    void startModule();
+    bool finishModule();
     llvm::Function* emitFunctionProto(const FunctionDecl& FunctionDecl);
     llvm::BasicBlock* emitBlock(std::string_view Name) const;
+    llvm::AllocaInst* createEntryAlloca(llvm::Type* Ty, const llvm::Twine& Name);
+    bool isSSACandidate(const Nameable& Name, llvm::Type* Ty) const;
+    void sealBlock(llvm::BasicBlock* Block);
     llvm::Value* emitLogicalAnd(const Expression& Left, const Expression& Right);
     llvm::Value* emitLogicalOr(const Expression& Left, const Expression& Right);
     llvm::Value* emitRelational(const Expression& Left, const Expression& Right, TokenKind Op);
@@ -48,10 +79,17 @@ private:
     std::unique_ptr<llvm::IRBuilder<>> Builder;
     std::unique_ptr<llvm::LLVMContext> Context;
     std::unique_ptr<llvm::Module> TheModule;
+    std::unique_ptr<llvm::TargetMachine> Target;
     const FunctionDecl* CurrentFunction = nullptr;
     llvm::Function* llvmFunction = nullptr;
+    // Allocas are inserted before this placeholder in the entry block, so a
+    // let inside a loop does not allocate on every iteration.
+    llvm::Instruction* AllocaInsertPt = nullptr;
     std::unique_ptr<TypeEmitter> TyEmitter;
-    std::map<const Nameable*, llvm::Value*> NameValues;
+    DenseTable<llvm::Value*> NameValues;
+    DenseTable<const NamedExpr*> AddressTaken;
+    SSABuilder SSA;
     Seman& SemanInfo;
+    CodeGenOptions Options;
 
 };
\ No newline at end of file
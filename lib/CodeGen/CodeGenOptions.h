@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+enum class OptLevel : std::uint8_t {
+    O0,
+    O1,
+    O2,
+    O3
+};
+
+struct CodeGenOptions {
+    OptLevel Opt = OptLevel::O0;
+    // Keep integer, floating-point and bool locals in SSA registers from the
+    // start instead of in allocas that mem2reg has to promote.
+    bool EmitSSA = false;
+    // An empty triple means the host. CPU "native" selects the host CPU and
+    // its features.
+    std::string TargetTriple;
+    std::string CPU;
+    std::string Features;
+    // Granularity of emitParallel. Fixed per input rather than derived from
+    // the thread count, so sharded output does not depend on the machine.
+    std::uint32_t FunctionsPerShard = 64;
+};
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "CompilationCache.h"
+#include "CodeGen.h"
+#include "AST/Module.h"
+#include "Parser/Parser.h"
+#include "Seman/Seman.h"
+#include "Utils/ErrorReporter.h"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/SHA256.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace {
+    // Bump when the compiler's output changes for the same input.
+    constexpr std::string_view CacheFormat = "unl-cache-1";
+    constexpr std::string_view TempSuffix = ".tmp";
+
+    // Length-prefixed, so adjacent fields cannot run into each other.
+    void appendField(std::string& Buffer, std::string_view Field) {
+        Buffer += std::to_string(Field.size());
+        Buffer += ':';
+        Buffer += Field;
+    }
+
+    std::string toHex(const std::array<std::uint8_t, 32>& Digest) {
+        constexpr std::string_view Digits = "0123456789abcdef";
+        std::string Hex;
+        for (const auto Byte : Digest) {
+            Hex += Digits[Byte >> 4];
+            Hex += Digits[Byte & 0xF];
+        }
+        return Hex;
+    }
+
+    std::string makeTempName() {
+        thread_local std::mt19937_64 Random(std::random_device{}());
+        return std::to_string(Random()) + std::string(TempSuffix);
+    }
+}
+
+CompilationCache::CompilationCache(std::filesystem::path Directory, std::uint64_t MaxBytes) :
+    Directory(std::move(Directory)), MaxBytes(MaxBytes) {
+    std::error_code EC;
+    std::filesystem::create_directories(this->Directory, EC);
+}
+
+std::string CompilationCache::computeKey(std::string_view Source, const CodeGenOptions& Options, OutputKind Kind,
+                                         std::span<const std::string> DependencyKeys) {
+    std::string Buffer;
+    appendField(Buffer, CacheFormat);
+    appendField(Buffer, LLVM_VERSION_STRING);
+    appendField(Buffer, std::to_string(static_cast<int>(Options.Opt)));
+    appendField(Buffer, Options.EmitSSA ? "ssa" : "mem");
+    appendField(Buffer, getEffectiveTriple(Options));
+    appendField(Buffer, getEffectiveCPU(Options));
+    appendField(Buffer, getEffectiveFeatures(Options));
+    appendField(Buffer, std::to_string(static_cast<int>(Kind)));
+    for (const auto& Dependency : DependencyKeys) {
+        appendField(Buffer, Dependency);
+    }
+    appendField(Buffer, Source);
+    const auto Bytes = reinterpret_cast<const std::uint8_t*>(Buffer.data());
+    return toHex(llvm::SHA256::hash(llvm::ArrayRef<std::uint8_t>(Bytes, Buffer.size())));
+}
+
+std::optional<std::string> CompilationCache::lookup(const std::string& Key) {
+    const auto Path = Directory / Key;
+    std::ifstream In(Path, std::ios::binary);
+    if (!In) {
+        ++Misses;
+        return std::nullopt;
+    }
+    std::string Data((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+    if (In.bad()) {
+        ++Misses;
+        return std::nullopt;
+    }
+    std::error_code EC;
+    std::filesystem::last_write_time(Path, std::filesystem::file_time_type::clock::now(), EC);
+    ++Hits;
+    return Data;
+}
+
+void CompilationCache::store(const std::string& Key, std::string_view Data) {
+    const auto TempPath = Directory / (Key + "." + makeTempName());
+    {
+        std::ofstream Out(TempPath, std::ios::binary | std::ios::trunc);
+        Out.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+        if (!Out) {
+            std::error_code EC;
+            std::filesystem::remove(TempPath, EC);
+            return;
+        }
+    }
+    // Another process may have stored the same key first; the contents are
+    // identical, so whichever rename lands last is fine.
+    std::error_code EC;
+    std::filesystem::rename(TempPath, Directory / Key, EC);
+    if (EC) {
+        std::filesystem::remove(TempPath, EC);
+        return;
+    }
+    ++Stores;
+    evict();
+}
+
+void CompilationCache::evict() {
+    struct Entry {
+        std::filesystem::path Path;
+        std::filesystem::file_time_type LastUse;
+        std::uint64_t Size;
+    };
+    std::vector<Entry> Entries;
+    std::uint64_t TotalSize = 0;
+    std::error_code EC;
+    for (const auto& File : std::filesystem::directory_iterator(Directory, EC)) {
+        std::error_code FileEC;
+        if (!File.is_regular_file(FileEC) || File.path().extension() == TempSuffix) {
+            continue;
+        }
+        const auto Size = File.file_size(FileEC);
+        const auto LastUse = File.last_write_time(FileEC);
+        if (FileEC) {
+            continue;
+        }
+        Entries.push_back({ File.path(), LastUse, Size });
+        TotalSize += Size;
+    }
+    if (TotalSize <= MaxBytes) {
+        return;
+    }
+
+    std::ranges::sort(Entries, {}, &Entry::LastUse);
+    for (const auto& Entry : Entries) {
+        if (TotalSize <= MaxBytes) {
+            break;
+        }
+        if (std::filesystem::remove(Entry.Path, EC)) {
+            TotalSize -= Entry.Size;
+            ++Evictions;
+        }
+    }
+}
+
+CacheStats CompilationCache::getStats() const {
+    return { Hits.load(), Misses.load(), Stores.load(), Evictions.load() };
+}
+
+std::optional<std::string> compileCached(CompilationCache& Cache, SourceFile& Source, const CodeGenOptions& Options,
+                                         OutputKind Kind, ErrorReporter& Reporter) {
+    const auto Key = CompilationCache::computeKey(Source.getSourceCode(), Options, Kind);
+    if (auto Cached = Cache.lookup(Key)) {
+        return Cached;
+    }
+
+    const auto ErrorsBefore = Reporter.getNumErrors();
+    auto Module = Parser::parseSourceFile(Source, Reporter);
+    Seman SemanInfo(*Module->TyContext, Reporter);
+    SemanInfo.visit(*Module);
+    if (Reporter.getNumErrors() != ErrorsBefore) {
+        return std::nullopt;
+    }
+
+    CodeGen Gen(SemanInfo, Options);
+    if (!Gen.doIt(*Module)) {
+        return std::nullopt;
+    }
+    llvm::SmallVector<char, 0> Output;
+    llvm::raw_svector_ostream Out(Output);
+    std::string Error;
+    if (!Gen.emitToStream(Out, Kind, Error)) {
+        llvm::errs() << Error << "\n";
+        return std::nullopt;
+    }
+    std::string Data(Output.data(), Output.size());
+    Cache.store(Key, Data);
+    return Data;
+}
\ No newline at end of file
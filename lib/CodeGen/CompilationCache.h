@@ -0,0 +1,56 @@
+#pragma once
+#include "CodeGenOptions.h"
+#include "ObjectEmitter.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+class ErrorReporter;
+class SourceFile;
+
+struct CacheStats {
+    std::uint64_t Hits = 0;
+    std::uint64_t Misses = 0;
+    std::uint64_t Stores = 0;
+    std::uint64_t Evictions = 0;
+};
+
+// On-disk cache of compiler output keyed by a content hash. Entries are
+// written to a temporary file and renamed into place, so concurrent builds
+// sharing the directory only ever see complete entries. A hit refreshes the
+// entry's modification time; storing evicts the least recently used entries
+// until the directory fits in MaxBytes. Failures to read or write the cache
+// are treated as misses.
+class CompilationCache {
+public:
+    CompilationCache(std::filesystem::path Directory, std::uint64_t MaxBytes);
+
+    // Hashes the source text, every option that affects the output (with the
+    // host triple and CPU resolved) and the keys of resolved dependencies.
+    static std::string computeKey(std::string_view Source, const CodeGenOptions& Options, OutputKind Kind,
+                                  std::span<const std::string> DependencyKeys = {});
+
+    std::optional<std::string> lookup(const std::string& Key);
+    void store(const std::string& Key, std::string_view Data);
+
+    CacheStats getStats() const;
+private:
+    void evict();
+
+    std::filesystem::path Directory;
+    std::uint64_t MaxBytes;
+    std::atomic<std::uint64_t> Hits = 0;
+    std::atomic<std::uint64_t> Misses = 0;
+    std::atomic<std::uint64_t> Stores = 0;
+    std::atomic<std::uint64_t> Evictions = 0;
+};
+
+// Returns the Kind output for Source, either from Cache or by running the
+// parser, Seman and CodeGen and storing the result. Sources with errors are
+// reported to Reporter and not cached.
+std::optional<std::string> compileCached(CompilationCache& Cache, SourceFile& Source, const CodeGenOptions& Options,
+                                         OutputKind Kind, ErrorReporter& Reporter);
\ No newline at end of file
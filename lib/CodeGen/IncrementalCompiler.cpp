@@ -0,0 +1,396 @@
+#include "IncrementalCompiler.h"
+#include "CodeGen.h"
+#include "AST/Module.h"
+#include "Parser/Parser.h"
+#include "Seman/Seman.h"
+#include "Utils/TimeReport.h"
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    constexpr std::uint64_t FNVOffset = 14695981039346656037ULL;
+    constexpr std::uint64_t FNVPrime = 1099511628211ULL;
+
+    // FNV-1a over the kinds and spellings of tokens [Begin, End), so edits to whitespace do not count as
+    // changes.
+    std::uint64_t hashTokens(const TokenBuffer& Tokens, std::size_t Begin, std::size_t End, std::uint64_t Hash = FNVOffset) {
+        for (auto Index = Begin; Index < End; Index++) {
+            const auto Tok = Tokens.getToken(Index);
+            Hash = (Hash ^ std::to_underlying(Tok.getKind())) * FNVPrime;
+            for (const auto Char : Tok.getValue()) {
+                Hash = (Hash ^ static_cast<std::uint8_t>(Char)) * FNVPrime;
+            }
+        }
+        return Hash;
+    }
+
+    // Collects the identifiers a declaration refers to: the names in its expressions and types.
+    class UseCollector : public AstConstVisitor {
+    public:
+        explicit UseCollector(std::vector<std::uint32_t>& Uses) : Uses(Uses) {}
+        void addType(const Type* Ty) {
+            if (Ty == nullptr) {
+                return;
+            }
+            if (Ty->isPointerType() || Ty->isArrayType()) {
+                return addType(Ty->as<PointerType>().getElementType());
+            }
+            if (Ty->getTag() == TypeTag::Unresolved) {
+                Uses.push_back(Ty->as<UnresolvedType>().getIdentifier().getID());
+            }
+        }
+        void visit(const NamedExpr& Node) override {
+            Uses.push_back(Node.getIdentifier().getID());
+        }
+        void visit(const LetStmt& Node) override {
+            addType(Node.getTypeInfo().getType());
+            AstConstVisitor::visit(Node);
+        }
+        void visit(const CastExpr& Node) override {
+            addType(Node.getTypeInfo().getType());
+            AstConstVisitor::visit(Node);
+        }
+    private:
+        std::vector<std::uint32_t>& Uses;
+    };
+
+    std::vector<std::uint32_t> collectSignatureUses(const Declaration& Decl) {
+        std::vector<std::uint32_t> Uses;
+        UseCollector Collector(Uses);
+        if (const auto Function = dynamic_cast<const FunctionDecl*>(&Decl)) {
+            for (const auto& Param : Function->getParams()) {
+                Collector.addType(Param.ParamType);
+            }
+            Collector.addType(&Function->getRetType());
+        } else {
+            for (const auto& Field : static_cast<const StructDecl&>(Decl).getFields()) {
+                Collector.addType(Field.FieldType);
+            }
+        }
+        return Uses;
+    }
+
+    std::vector<std::uint32_t> collectBodyUses(const FunctionDecl& Function) {
+        std::vector<std::uint32_t> Uses;
+        UseCollector Collector(Uses);
+        Function.getBody().accept(Collector);
+        return Uses;
+    }
+
+    bool usesAny(const std::vector<std::uint32_t>& Uses, const std::unordered_set<std::uint32_t>& Names) {
+        return std::ranges::any_of(Uses, [&Names](auto Name) { return Names.contains(Name); });
+    }
+
+    // Reports the errors in Source the way a normal compile would.
+    void reportErrors(SourceFile& Source, ErrorReporter& Reporter) {
+        const auto NumErrors = Reporter.getNumErrors();
+        const auto TyContext = std::make_shared<TypeContext>();
+        const auto Module = Parser::parseSourceFile(Source, Reporter, TyContext);
+        if (Reporter.getNumErrors() == NumErrors) {
+            Seman Checker(*TyContext, Reporter);
+            Checker.visit(*Module);
+        }
+    }
+}
+
+struct IncrementalCompiler::Unit {
+    const IdentifierInfo* Name = nullptr;
+    bool IsFunction = false;
+    // Of every token, and of those before the body of a function.
+    std::uint64_t Hash = 0;
+    std::uint64_t SignatureHash = 0;
+    // Byte offsets of the declaration in the text it was last built from.
+    std::size_t Begin = 0;
+    std::size_t End = 0;
+    Declaration* Decl = nullptr;
+    std::vector<std::uint32_t> SignatureUses;
+    std::vector<std::uint32_t> BodyUses;
+    // Everything parsed in one rebuild shares an arena, which lives as long as any of it is in use.
+    std::shared_ptr<Arena> DeclArena;
+    std::shared_ptr<Arena> BodyArena;
+};
+
+IncrementalCompiler::IncrementalCompiler(std::string Path, const CodeGenOptions& Options) :
+    Path(std::move(Path)), Options(Options) {
+    reset();
+}
+
+IncrementalCompiler::~IncrementalCompiler() = default;
+
+bool IncrementalCompiler::rebuild(std::string Code, ErrorReporter& Reporter) {
+    TimeScope Scope("incremental rebuild");
+    Discarded.str({});
+    auto NewSource = std::make_unique<SourceFile>(std::move(Code), Path);
+    Stats = {};
+    if (Failed || !update(*NewSource, true)) {
+        reset();
+        Stats = { .FullRebuild = true };
+        if (!update(*NewSource, false)) {
+            reset();
+            Failed = true;
+            reportErrors(*NewSource, Reporter);
+            return false;
+        }
+    }
+    // The old module is gone, so nothing refers to the old source any more.
+    Source = std::move(NewSource);
+    Failed = false;
+    auto& Report = TimeReport::get();
+    Report.addCounter("declarations reused", Stats.Reused);
+    Report.addCounter("bodies reparsed", Stats.BodiesReparsed);
+    Report.addCounter("declarations reparsed", Stats.Reparsed);
+    Report.addCounter("functions recompiled", Stats.Recompiled);
+    return true;
+}
+
+llvm::Module* IncrementalCompiler::getModule() const {
+    return Gen->getModule();
+}
+
+bool IncrementalCompiler::emitFile(const std::string& Path, OutputKind Kind) const {
+    return Gen->emitOptimizedFile(Path, Kind);
+}
+
+void IncrementalCompiler::reset() {
+    Gen = nullptr;
+    SemanInfo = nullptr;
+    TheModule = nullptr;
+    Units.clear();
+    RetiredArenas.clear();
+    TyContext = std::make_shared<TypeContext>();
+    SemanInfo = std::make_unique<Seman>(*TyContext, QuietReporter);
+    Gen = std::make_unique<CodeGen>(*SemanInfo, Options);
+}
+
+// Builds NewSource on top of the current state. Unless Incremental, that state is fresh and everything is
+// parsed. Returns false if the edit cannot be applied incrementally or does not compile; the state is then
+// inconsistent and has to be reset.
+bool IncrementalCompiler::update(SourceFile& NewSource, bool Incremental) {
+    enum class Action : std::uint8_t { Reuse, ReparseBody, Reparse };
+
+    const auto NumErrors = QuietReporter.getNumErrors();
+    const auto Code = NewSource.getSourceCode();
+    std::unordered_map<std::uint32_t, Unit*> OldUnits;
+    for (auto& Old : Units) {
+        OldUnits.emplace(Old.Name->getID(), &Old);
+    }
+    if (OldUnits.size() != Units.size()) {
+        return false;
+    }
+
+    // Diff against the previous text: the declarations wholly before the first changed byte, or after the last,
+    // are unchanged. Only the text between them is lexed again.
+    std::size_t NumBefore = 0;
+    std::size_t NumAfter = 0;
+    std::size_t RegionBegin = 0;
+    std::size_t RegionEnd = Code.size();
+    std::ptrdiff_t Delta = 0;
+    if (Incremental) {
+        const auto OldCode = Source->getSourceCode();
+        Delta = std::ssize(Code) - std::ssize(OldCode);
+        const auto Limit = std::min(OldCode.size(), Code.size());
+        std::size_t Prefix = 0;
+        while (Prefix < Limit && OldCode[Prefix] == Code[Prefix]) {
+            Prefix++;
+        }
+        std::size_t Suffix = 0;
+        while (Suffix < Limit - Prefix && OldCode[OldCode.size() - 1 - Suffix] == Code[Code.size() - 1 - Suffix]) {
+            Suffix++;
+        }
+        const auto ChangeEnd = OldCode.size() - Suffix;
+        while (NumBefore < Units.size() && Units[NumBefore].End < Prefix) {
+            NumBefore++;
+        }
+        while (NumAfter < Units.size() - NumBefore && Units[Units.size() - 1 - NumAfter].Begin > ChangeEnd) {
+            NumAfter++;
+        }
+        if (NumBefore > 0) {
+            RegionBegin = Units[NumBefore - 1].End;
+        }
+        if (NumAfter > 0) {
+            RegionEnd = Units[Units.size() - NumAfter].Begin + Delta;
+        }
+    }
+    const TokenBuffer Tokens(Code, RegionBegin, RegionEnd);
+    const auto Ranges = Parser::findTopLevelDecls(Tokens);
+    if (!Ranges) {
+        return false;
+    }
+
+    // Match the new declarations to the old ones by name.
+    const auto NumUnits = NumBefore + Ranges->size() + NumAfter;
+    std::vector<Unit> NewUnits(NumUnits);
+    std::vector<Unit*> Previous(NumUnits);
+    std::vector<Action> Actions(NumUnits, Action::Reparse);
+    std::unordered_map<std::uint32_t, bool> NewNames;
+    const Unit* LastKept = nullptr;
+    for (std::size_t Index = 0; Index < NumUnits; Index++) {
+        auto& New = NewUnits[Index];
+        const auto IsRelexed = Index >= NumBefore && Index < NumBefore + Ranges->size();
+        if (!IsRelexed) {
+            const auto& Old = Units[Index < NumBefore ? Index : Index - NumUnits + Units.size()];
+            New.Name = Old.Name;
+            New.IsFunction = Old.IsFunction;
+            New.Hash = Old.Hash;
+            New.SignatureHash = Old.SignatureHash;
+            New.Begin = Index < NumBefore ? Old.Begin : Old.Begin + Delta;
+            New.End = Index < NumBefore ? Old.End : Old.End + Delta;
+        } else {
+            const auto [Begin, End] = (*Ranges)[Index - NumBefore];
+            if (Tokens.getKind(Begin + 1) != TokenKind::Identifier) {
+                return false;
+            }
+            New.Name = TyContext->getIdentifiers().get(Tokens.getToken(Begin + 1).getValue());
+            New.IsFunction = Tokens.getKind(Begin) == TokenKind::Function;
+            auto BodyBegin = Begin;
+            while (Tokens.getKind(BodyBegin) != TokenKind::LeftBrace) {
+                BodyBegin++;
+            }
+            New.SignatureHash = hashTokens(Tokens, Begin, BodyBegin);
+            New.Hash = hashTokens(Tokens, BodyBegin, End, New.SignatureHash);
+            New.Begin = Tokens.getToken(Begin).getStart().Offset;
+            New.End = Tokens.getToken(End - 1).getStart().Offset + 1;
+        }
+        if (!NewNames.emplace(New.Name->getID(), New.IsFunction).second && Incremental) {
+            return false;
+        }
+
+        const auto Iter = OldUnits.find(New.Name->getID());
+        if (Iter == OldUnits.end()) {
+            continue;
+        }
+        const auto Old = Iter->second;
+        if (Old->Hash == New.Hash) {
+            Actions[Index] = Action::Reuse;
+        } else if (Old->IsFunction && New.IsFunction && Old->SignatureHash == New.SignatureHash) {
+            Actions[Index] = Action::ReparseBody;
+        } else {
+            continue;
+        }
+        // The kept functions resolved their calls against the functions declared before them.
+        if (LastKept != nullptr && Old < LastKept) {
+            return false;
+        }
+        LastKept = Old;
+        Previous[Index] = Old;
+    }
+
+    // A declaration whose signature names a changed one has to be parsed again, since its types are resolved
+    // when it is, and so on for declarations naming that one.
+    std::unordered_set<std::uint32_t> ChangedNames;
+    std::vector<std::string> Removed;
+    for (std::size_t Index = 0; Index < NewUnits.size(); Index++) {
+        if (Actions[Index] == Action::Reparse) {
+            ChangedNames.insert(NewUnits[Index].Name->getID());
+        }
+    }
+    for (const auto& Old : Units) {
+        const auto Iter = NewNames.find(Old.Name->getID());
+        if (Iter == NewNames.end()) {
+            ChangedNames.insert(Old.Name->getID());
+            Stats.Removed++;
+        }
+        if (Old.IsFunction && (Iter == NewNames.end() || !Iter->second)) {
+            Removed.push_back(Old.Name->getName());
+        }
+    }
+    for (bool Grew = true; Grew;) {
+        Grew = false;
+        for (std::size_t Index = 0; Index < NewUnits.size(); Index++) {
+            if (Actions[Index] != Action::Reparse && usesAny(Previous[Index]->SignatureUses, ChangedNames)) {
+                Actions[Index] = Action::Reparse;
+                ChangedNames.insert(NewUnits[Index].Name->getID());
+                Grew = true;
+            }
+        }
+    }
+
+    const auto NewArena = std::make_shared<Arena>();
+    std::vector<AstPtr<Declaration>> Declarations;
+    std::unordered_set<const FunctionDecl*> Changed;
+    std::vector<const FunctionDecl*> ChangedInOrder;
+    {
+        TimeScope Scope("parse");
+        for (std::size_t Index = 0; Index < NewUnits.size(); Index++) {
+            auto& New = NewUnits[Index];
+            const auto Old = Previous[Index];
+            // A declaration outside the lexed text that has to be parsed again is lexed on its own.
+            std::optional<TokenBuffer> UnitTokens;
+            auto Range = TokenRange{};
+            if (Index >= NumBefore && Index < NumBefore + Ranges->size()) {
+                Range = (*Ranges)[Index - NumBefore];
+            } else if (Actions[Index] != Action::Reuse) {
+                UnitTokens.emplace(Code, New.Begin, New.End);
+                Range = { 0, UnitTokens->size() - 1 };
+            }
+            const auto& DeclTokens = UnitTokens ? *UnitTokens : Tokens;
+            switch (Actions[Index]) {
+            case Action::Reuse:
+                New.Decl = Old->Decl;
+                New.DeclArena = Old->DeclArena;
+                New.BodyArena = Old->BodyArena;
+                New.SignatureUses = std::move(Old->SignatureUses);
+                New.BodyUses = std::move(Old->BodyUses);
+                Stats.Reused++;
+                break;
+            case Action::ReparseBody: {
+                const auto Body = Parser::parseFunctionBody(NewSource, QuietReporter, DeclTokens, Range, TyContext, *NewArena);
+                if (Body == nullptr) {
+                    return false;
+                }
+                const auto Function = static_cast<FunctionDecl*>(Old->Decl);
+                Function->setBody(Body);
+                New.Decl = Function;
+                New.DeclArena = Old->DeclArena;
+                New.BodyArena = NewArena;
+                New.SignatureUses = std::move(Old->SignatureUses);
+                New.BodyUses = collectBodyUses(*Function);
+                Stats.BodiesReparsed++;
+                break;
+            }
+            case Action::Reparse:
+                New.Decl = Parser::parseDeclaration(NewSource, QuietReporter, DeclTokens, Range, TyContext, *NewArena);
+                if (New.Decl == nullptr) {
+                    return false;
+                }
+                New.DeclArena = NewArena;
+                New.BodyArena = NewArena;
+                New.SignatureUses = collectSignatureUses(*New.Decl);
+                if (New.IsFunction) {
+                    New.BodyUses = collectBodyUses(static_cast<const FunctionDecl&>(*New.Decl));
+                }
+                Stats.Reparsed++;
+                break;
+            }
+            Declarations.push_back(New.Decl);
+            if (New.IsFunction && (Actions[Index] != Action::Reuse || usesAny(New.BodyUses, ChangedNames))) {
+                const auto Function = static_cast<const FunctionDecl*>(New.Decl);
+                Changed.insert(Function);
+                ChangedInOrder.push_back(Function);
+            }
+        }
+    }
+
+    auto NewModule = std::make_unique<Module>(std::move(Declarations), TyContext, NewSource, std::vector<std::unique_ptr<Arena>>{});
+    if (Incremental) {
+        SemanInfo->visitChanged(*NewModule, Changed);
+    } else {
+        SemanInfo->visit(*NewModule);
+    }
+    if (QuietReporter.getNumErrors() != NumErrors || !Gen->update(ChangedInOrder, Removed)) {
+        return false;
+    }
+    Stats.Recompiled = static_cast<std::uint32_t>(ChangedInOrder.size());
+
+    for (const auto& Old : Units) {
+        if (!Old.IsFunction && ChangedNames.contains(Old.Name->getID())) {
+            RetiredArenas.push_back(Old.DeclArena);
+        }
+    }
+    TheModule = std::move(NewModule);
+    Units = std::move(NewUnits);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "CodeGenOptions.h"
+#include "ObjectEmitter.h"
+#include "Utils/ErrorReporter.h"
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace llvm {
+    class Module;
+}
+
+class Arena;
+class CodeGen;
+class Module;
+class Seman;
+class SourceFile;
+class TypeContext;
+
+// What the last IncrementalCompiler::rebuild reused and redid, counted in top-level declarations.
+struct RebuildStats {
+    // Kept from the previous build without being parsed again.
+    std::uint32_t Reused = 0;
+    // Functions whose signature did not change, so only their body was parsed again.
+    std::uint32_t BodiesReparsed = 0;
+    // Parsed again in full: new, edited, or with a signature naming a declaration that changed.
+    std::uint32_t Reparsed = 0;
+    std::uint32_t Removed = 0;
+    // Functions checked and emitted again: the reparsed ones and those whose body names a declaration that
+    // changed.
+    std::uint32_t Recompiled = 0;
+    // Nothing was kept, as for the first build or one after an edit that could not be applied incrementally.
+    bool FullRebuild = false;
+};
+
+// Compiles successive versions of one source file, such as an editor buffer, redoing only the work an edit
+// invalidates. The new text is diffed against the previous one, and the part between the declarations wholly
+// before and after the changed bytes is lexed again and split into top-level declarations. These are matched
+// by name against the previous version. An unchanged declaration keeps its AST and analysis, a function whose
+// signature is unchanged has only its body parsed again, and anything else is parsed again in full. A
+// declaration whose signature names a changed one is parsed again too; a function whose body names one is
+// checked and emitted again. The LLVM module is updated in place (see CodeGen::update).
+//
+// Reused nodes keep the source locations of the version they were parsed from. So an edit that leads to any
+// diagnostic, reorders declarations, or declares a name twice is compiled from scratch, and diagnostics are
+// always reported against the current text.
+class IncrementalCompiler {
+public:
+    explicit IncrementalCompiler(std::string Path, const CodeGenOptions& Options = {});
+    ~IncrementalCompiler();
+
+    // Compiles Code, the new contents of the file. Returns false, with the errors reported to Reporter, if it
+    // does not compile; the next rebuild then starts from scratch.
+    bool rebuild(std::string Code, ErrorReporter& Reporter);
+    const RebuildStats& getStats() const { return Stats; }
+    // The unoptimized module of the last successful rebuild.
+    llvm::Module* getModule() const;
+    // Optimizes a copy of the module at Options.Opt and writes it to Path.
+    bool emitFile(const std::string& Path, OutputKind Kind) const;
+
+private:
+    struct Unit;
+
+    void reset();
+    bool update(SourceFile& NewSource, bool Incremental);
+
+    std::string Path;
+    CodeGenOptions Options;
+    // The analyses need somewhere to report to; anything reported there makes rebuild start over.
+    std::ostringstream Discarded;
+    ErrorReporter QuietReporter{ Discarded };
+    std::shared_ptr<TypeContext> TyContext;
+    std::unique_ptr<Seman> SemanInfo;
+    std::unique_ptr<CodeGen> Gen;
+    std::unique_ptr<SourceFile> Source;
+    std::unique_ptr<Module> TheModule;
+    std::vector<Unit> Units;
+    // The TypeContext keeps the type of a replaced struct, and the type refers to its declaration.
+    std::vector<std::shared_ptr<Arena>> RetiredArenas;
+    bool Failed = true;
+    RebuildStats Stats;
+};
\ No newline at end of file
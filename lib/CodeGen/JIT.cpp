@@ -0,0 +1,95 @@
+#include "JIT.h"
+#include "ObjectEmitter.h"
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/Module.h>
+
+namespace {
+    template <typename T>
+    std::optional<T> takeValue(llvm::Expected<T> Value, std::string& Error) {
+        if (!Value) {
+            Error = llvm::toString(Value.takeError());
+            return std::nullopt;
+        }
+        return std::move(*Value);
+    }
+
+    template <typename RetTy>
+    std::int64_t call(std::uint64_t Address) {
+        return static_cast<std::int64_t>(reinterpret_cast<RetTy (*)()>(Address)());
+    }
+
+    std::int64_t callEntry(std::uint64_t Address, unsigned ReturnBits) {
+        switch (ReturnBits) {
+            case 0:
+                reinterpret_cast<void (*)()>(Address)();
+                return 0;
+            case 1: return call<bool>(Address);
+            case 8: return call<std::int8_t>(Address);
+            case 16: return call<std::int16_t>(Address);
+            case 32: return call<std::int32_t>(Address);
+            default: return call<std::int64_t>(Address);
+        }
+    }
+}
+
+std::optional<JITResult> runJIT(llvm::orc::ThreadSafeModule Module, std::string_view Entry, std::string& Error) {
+    const auto Start = std::chrono::steady_clock::now();
+
+    unsigned ReturnBits = 0;
+    const auto Valid = Module.withModuleDo([&](llvm::Module& M) {
+        const auto Function = M.getFunction(llvm::StringRef(Entry.data(), Entry.size()));
+        if (Function == nullptr || Function->isDeclaration()) {
+            Error = "no function named '" + std::string(Entry) + "'";
+            return false;
+        }
+        const auto RetTy = Function->getReturnType();
+        const auto Bits = RetTy->isIntegerTy() ? RetTy->getIntegerBitWidth() : 0;
+        const bool SupportedReturn = RetTy->isVoidTy() || Bits == 1 || Bits == 8 || Bits == 16 || Bits == 32 || Bits == 64;
+        if (Function->arg_size() != 0 || !SupportedReturn) {
+            Error = "'" + std::string(Entry) + "' must take no parameters and return bool, an integer or void";
+            return false;
+        }
+        ReturnBits = Bits;
+        return true;
+    });
+    if (!Valid) {
+        return std::nullopt;
+    }
+
+    initializeNativeTargets();
+    auto JIT = takeValue(llvm::orc::LLLazyJITBuilder().create(), Error);
+    if (!JIT) {
+        return std::nullopt;
+    }
+    auto& Engine = **JIT;
+    const auto Prefix = Engine.getDataLayout().getGlobalPrefix();
+    auto ProcessSymbols = takeValue(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(Prefix), Error);
+    if (!ProcessSymbols) {
+        return std::nullopt;
+    }
+    Engine.getMainJITDylib().addGenerator(std::move(*ProcessSymbols));
+    if (auto Err = Engine.addLazyIRModule(std::move(Module))) {
+        Error = llvm::toString(std::move(Err));
+        return std::nullopt;
+    }
+
+    JITResult Result;
+    const auto Ready = std::chrono::steady_clock::now();
+    Result.SetupTime = Ready - Start;
+
+    auto Symbol = takeValue(Engine.lookup(llvm::StringRef(Entry.data(), Entry.size())), Error);
+    if (!Symbol) {
+        return std::nullopt;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    const auto Address = Symbol->getValue();
+#else
+    const auto Address = Symbol->getAddress();
+#endif
+    Result.ReturnValue = callEntry(Address, ReturnBits);
+    Result.FirstCallTime = std::chrono::steady_clock::now() - Ready;
+    return Result;
+}
\ No newline at end of file
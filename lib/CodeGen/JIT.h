@@ -0,0 +1,26 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace llvm::orc {
+    class ThreadSafeModule;
+}
+
+struct JITResult {
+    std::int64_t ReturnValue = 0;
+    // Creating the JIT and adding the module; nothing is compiled yet.
+    std::chrono::nanoseconds SetupTime{};
+    // From looking up the entry until it returns, including compiling every
+    // function the call reaches. Setup plus this is the time to first result,
+    // to compare with emitting and linking an object file.
+    std::chrono::nanoseconds FirstCallTime{};
+};
+
+// Runs Entry from Module in-process with an ORC LLLazyJIT, which compiles
+// each function on its first call. Entry must take no parameters and return
+// bool, an integer or void. Returns std::nullopt and sets Error
+// on failure.
+std::optional<JITResult> runJIT(llvm::orc::ThreadSafeModule Module, std::string_view Entry, std::string& Error);
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "ObjectEmitter.h"
+#include "Utils/TimeReport.h"
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#if __has_include(<llvm/TargetParser/Host.h>)
+#include <llvm/TargetParser/Host.h>
+#else
+#include <llvm/Support/Host.h>
+#endif
+#include <mutex>
+
+namespace {
+#if LLVM_VERSION_MAJOR >= 18
+    using CodeGenLevel = llvm::CodeGenOptLevel;
+    constexpr auto AssemblyFileType = llvm::CodeGenFileType::AssemblyFile;
+    constexpr auto ObjectFileType = llvm::CodeGenFileType::ObjectFile;
+#else
+    using CodeGenLevel = llvm::CodeGenOpt::Level;
+    constexpr auto AssemblyFileType = llvm::CGFT_AssemblyFile;
+    constexpr auto ObjectFileType = llvm::CGFT_ObjectFile;
+#endif
+
+    CodeGenLevel toCodeGenLevel(OptLevel Level) {
+        switch (Level) {
+            case OptLevel::O0: return CodeGenLevel::None;
+            case OptLevel::O1: return CodeGenLevel::Less;
+            case OptLevel::O2: return CodeGenLevel::Default;
+            case OptLevel::O3: return CodeGenLevel::Aggressive;
+        }
+        return CodeGenLevel::Default;
+    }
+
+}
+
+void initializeNativeTargets() {
+    static std::once_flag Once;
+    std::call_once(Once, [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+    });
+}
+
+void initializeAllTargets() {
+    static std::once_flag Once;
+    std::call_once(Once, [] {
+        llvm::InitializeAllTargetInfos();
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmPrinters();
+    });
+}
+
+std::optional<OutputKind> getOutputKindFromPath(std::string_view Path) {
+    const auto Dot = Path.rfind('.');
+    if (Dot == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto Extension = Path.substr(Dot + 1);
+    if (Extension == "o" || Extension == "obj") {
+        return OutputKind::Object;
+    }
+    if (Extension == "s" || Extension == "asm") {
+        return OutputKind::Assembly;
+    }
+    if (Extension == "bc") {
+        return OutputKind::Bitcode;
+    }
+    return std::nullopt;
+}
+
+std::string getEffectiveTriple(const CodeGenOptions& Options) {
+    return Options.TargetTriple.empty() ? llvm::sys::getDefaultTargetTriple() : Options.TargetTriple;
+}
+
+std::string getEffectiveCPU(const CodeGenOptions& Options) {
+    return Options.CPU == "native" ? llvm::sys::getHostCPUName().str() : Options.CPU;
+}
+
+std::string getEffectiveFeatures(const CodeGenOptions& Options) {
+    if (Options.CPU != "native") {
+        return Options.Features;
+    }
+    std::string Features;
+    llvm::StringMap<bool> HostFeatures;
+    if (llvm::sys::getHostCPUFeatures(HostFeatures)) {
+        for (const auto& Feature : HostFeatures) {
+            Features += (Feature.getValue() ? "+" : "-") + Feature.getKey().str() + ",";
+        }
+    }
+    // Explicit features come last, so they override what the host reports.
+    Features += Options.Features;
+    if (!Features.empty() && Features.back() == ',') {
+        Features.pop_back();
+    }
+    return Features;
+}
+
+std::unique_ptr<llvm::TargetMachine> createTargetMachine(const CodeGenOptions& Options, std::string& Error) {
+    initializeNativeTargets();
+    if (!Options.TargetTriple.empty()) {
+        initializeAllTargets();
+    }
+    const auto Triple = getEffectiveTriple(Options);
+    const auto Target = llvm::TargetRegistry::lookupTarget(Triple, Error);
+    if (Target == nullptr) {
+        return nullptr;
+    }
+    const auto CPU = getEffectiveCPU(Options);
+    const auto Features = getEffectiveFeatures(Options);
+    llvm::TargetOptions TargetOpts;
+    const auto Machine = Target->createTargetMachine(Triple, CPU, Features, TargetOpts, llvm::Reloc::PIC_,
+                                                     {}, toCodeGenLevel(Options.Opt));
+    if (Machine == nullptr) {
+        Error = "cannot create target machine for '" + Triple + "'";
+    }
+    return std::unique_ptr<llvm::TargetMachine>(Machine);
+}
+
+bool emitModule(llvm::Module& Module, llvm::TargetMachine* Target, OutputKind Kind, const std::string& Path, std::string& Error) {
+    std::error_code EC;
+    const auto Flags = Kind == OutputKind::Assembly ? llvm::sys::fs::OF_Text : llvm::sys::fs::OF_None;
+    llvm::raw_fd_ostream Out(Path, EC, Flags);
+    if (EC) {
+        Error = "cannot open '" + Path + "': " + EC.message();
+        return false;
+    }
+    return emitModule(Module, Target, Kind, Out, Error);
+}
+
+bool emitModule(llvm::Module& Module, llvm::TargetMachine* Target, OutputKind Kind, llvm::raw_pwrite_stream& Out, std::string& Error) {
+    TimeScope Scope("emit");
+    if (Kind == OutputKind::Bitcode) {
+        llvm::WriteBitcodeToFile(Module, Out);
+        return true;
+    }
+    if (Target == nullptr) {
+        Error = "no target machine for native output";
+        return false;
+    }
+
+    llvm::legacy::PassManager Passes;
+    const auto FileType = Kind == OutputKind::Object ? ObjectFileType : AssemblyFileType;
+    if (Target->addPassesToEmitFile(Passes, Out, nullptr, FileType)) {
+        Error = "target cannot emit this file type";
+        return false;
+    }
+    Passes.run(Module);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include "CodeGenOptions.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace llvm {
+    class Module;
+    class TargetMachine;
+    class raw_pwrite_stream;
+}
+
+enum class OutputKind : std::uint8_t {
+    Object,
+    Assembly,
+    Bitcode
+};
+
+// Register the host target, or all targets LLVM was built with. Safe to call
+// from several threads.
+void initializeNativeTargets();
+void initializeAllTargets();
+
+// Picks the output kind from a file extension: .o/.obj, .s/.asm or .bc.
+std::optional<OutputKind> getOutputKindFromPath(std::string_view Path);
+
+// The triple, CPU and features Options resolve to on this machine: the host
+// triple for an empty triple, and the host CPU and its features for "native".
+// Like -march=native, "native" also enables what the host supports beyond its
+// CPU model; Options.Features still override that.
+std::string getEffectiveTriple(const CodeGenOptions& Options);
+std::string getEffectiveCPU(const CodeGenOptions& Options);
+std::string getEffectiveFeatures(const CodeGenOptions& Options);
+
+// Creates a TargetMachine for Options.TargetTriple, or for the host if it is
+// empty. Every target is registered once a triple is given. On failure
+// returns nullptr and describes the problem in Error.
+std::unique_ptr<llvm::TargetMachine> createTargetMachine(const CodeGenOptions& Options, std::string& Error);
+
+// Writes Module to Path. Object and assembly output need a TargetMachine whose
+// triple and data layout the module was built for; bitcode does not.
+bool emitModule(llvm::Module& Module, llvm::TargetMachine* Target, OutputKind Kind, const std::string& Path, std::string& Error);
+bool emitModule(llvm::Module& Module, llvm::TargetMachine* Target, OutputKind Kind, llvm::raw_pwrite_stream& Out, std::string& Error);
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Optimizer.h"
+#include "Utils/TimeReport.h"
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Target/TargetMachine.h>
+#include <vector>
+
+namespace {
+    llvm::OptimizationLevel toLLVMLevel(OptLevel Level) {
+        switch (Level) {
+            case OptLevel::O0: return llvm::OptimizationLevel::O0;
+            case OptLevel::O1: return llvm::OptimizationLevel::O1;
+            case OptLevel::O2: return llvm::OptimizationLevel::O2;
+            case OptLevel::O3: return llvm::OptimizationLevel::O3;
+        }
+        return llvm::OptimizationLevel::O0;
+    }
+
+    // Times every pass run as a "pass: <name>" phase of the TimeReport and as
+    // a span of the trace, whichever are enabled. Only passes that ran no
+    // other pass are recorded: managers, adaptors and wrappers such as the
+    // inliner's would count their children twice.
+    class PassTimer {
+    public:
+        PassTimer() : Report(TimeReport::isEnabled() && TimeReport::shouldTimePasses()), Tracing(Trace::isEnabled()) {}
+
+        bool isActive() const { return Report || Tracing; }
+
+        void registerCallbacks(llvm::PassInstrumentationCallbacks& Callbacks) {
+            Callbacks.registerBeforeNonSkippedPassCallback([this](llvm::StringRef, llvm::Any) {
+                if (!Starts.empty()) {
+                    Starts.back().HasChildren = true;
+                }
+                Starts.push_back({ TimeReport::sample(), false });
+            });
+            Callbacks.registerAfterPassCallback([this](llvm::StringRef Name, llvm::Any, const llvm::PreservedAnalyses&) {
+                finish(Name);
+            });
+            Callbacks.registerAfterPassInvalidatedCallback([this](llvm::StringRef Name, const llvm::PreservedAnalyses&) {
+                finish(Name);
+            });
+        }
+    private:
+        struct RunningPass {
+            PhaseSample Start;
+            bool HasChildren;
+        };
+
+        void finish(llvm::StringRef Name) {
+            const auto Pass = Starts.back();
+            Starts.pop_back();
+            if (Pass.HasChildren) {
+                return;
+            }
+            if (Report) {
+                TimeReport::get().record("pass: " + Name.str(), Pass.Start);
+            }
+            if (Tracing) {
+                Trace::record(Name, {}, Pass.Start.Wall, std::chrono::steady_clock::now());
+            }
+        }
+
+        bool Report;
+        bool Tracing;
+        std::vector<RunningPass> Starts;
+    };
+}
+
+void optimizeModule(llvm::Module& Module, OptLevel Level, llvm::TargetMachine* Target) {
+    TimeScope Scope("optimize");
+    llvm::PassInstrumentationCallbacks Callbacks;
+    PassTimer Timer;
+    if (Timer.isActive()) {
+        Timer.registerCallbacks(Callbacks);
+    }
+
+    llvm::LoopAnalysisManager LAM;
+    llvm::FunctionAnalysisManager FAM;
+    llvm::CGSCCAnalysisManager CGAM;
+    llvm::ModuleAnalysisManager MAM;
+
+    llvm::PassBuilder Builder(Target, llvm::PipelineTuningOptions(), {}, &Callbacks);
+    Builder.registerModuleAnalyses(MAM);
+    Builder.registerCGSCCAnalyses(CGAM);
+    Builder.registerFunctionAnalyses(FAM);
+    Builder.registerLoopAnalyses(LAM);
+    Builder.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    const auto LLVMLevel = toLLVMLevel(Level);
+    auto Passes = Level == OptLevel::O0
+        ? Builder.buildO0DefaultPipeline(LLVMLevel)
+        : Builder.buildPerModuleDefaultPipeline(LLVMLevel);
+    Passes.run(Module, MAM);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include "CodeGenOptions.h"
+
+namespace llvm {
+    class Module;
+    class TargetMachine;
+}
+
+// Runs LLVM's default module pipeline for Level (mem2reg/SROA, instcombine,
+// GVN, loop passes, inlining and the vectorizers from -O2 up). At O0 only the
+// passes required for correctness, such as always-inline, are run. Target
+// supplies the cost model; without it the vectorizers have little to go on.
+void optimizeModule(llvm::Module& Module, OptLevel Level, llvm::TargetMachine* Target = nullptr);
\ No newline at end of file
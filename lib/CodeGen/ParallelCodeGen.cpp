@@ -0,0 +1,106 @@
+#include "ParallelCodeGen.h"
+#include "CodeGen.h"
+#include "AST/ASTVisitor.h"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Object/ArchiveWriter.h>
+#include <llvm/Support/MemoryBufferRef.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace {
+    class FunctionCollector : public AstConstVisitor {
+    public:
+        void visit(const FunctionDecl& Node) override { Functions.push_back(&Node); }
+        void visit(const StructDecl&) override {}
+        std::vector<const FunctionDecl*> Functions;
+    };
+
+    struct Shard {
+        std::span<const FunctionDecl* const> Functions;
+        std::string Name;
+        llvm::SmallVector<char, 0> Object;
+        std::string Error;
+        bool IsDarwin = false;
+    };
+
+    void emitShard(Shard& Shard, Seman& SemanInfo, const CodeGenOptions& Options) {
+        CodeGen Gen(SemanInfo, Options);
+        if (!Gen.doIt(Shard.Functions)) {
+            Shard.Error = Shard.Name + ": module verification failed";
+            return;
+        }
+        Shard.IsDarwin = llvm::Triple(Gen.getModule()->getTargetTriple()).isOSDarwin();
+        llvm::raw_svector_ostream Out(Shard.Object);
+        if (!Gen.emitToStream(Out, OutputKind::Object, Shard.Error)) {
+            Shard.Error = Shard.Name + ": " + Shard.Error;
+        }
+    }
+
+    bool writeArchive(const std::string& Path, const std::vector<Shard>& Shards) {
+        std::vector<llvm::NewArchiveMember> Members;
+        for (const auto& Shard : Shards) {
+            const llvm::StringRef Contents(Shard.Object.data(), Shard.Object.size());
+            Members.emplace_back(llvm::MemoryBufferRef(Contents, Shard.Name));
+        }
+        const auto Kind = !Shards.empty() && Shards.front().IsDarwin
+            ? llvm::object::Archive::K_DARWIN
+            : llvm::object::Archive::K_GNU;
+#if LLVM_VERSION_MAJOR >= 18
+        const auto Symtab = llvm::SymtabWritingMode::NormalSymtab;
+#else
+        const auto Symtab = true;
+#endif
+        if (auto Err = llvm::writeArchive(Path, Members, Symtab, Kind, true, false)) {
+            llvm::errs() << Path << ": " << llvm::toString(std::move(Err)) << "\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+bool emitParallel(const Module& Module, Seman& SemanInfo, const CodeGenOptions& Options, unsigned Threads,
+                  const std::string& Path) {
+    FunctionCollector Collector;
+    Module.accept(Collector);
+    const std::span<const FunctionDecl* const> Functions = Collector.Functions;
+
+    std::vector<Shard> Shards;
+    const std::size_t ShardSize = std::max<std::uint32_t>(Options.FunctionsPerShard, 1);
+    for (std::size_t Begin = 0; Begin < Functions.size(); Begin += ShardSize) {
+        auto& Shard = Shards.emplace_back();
+        Shard.Functions = Functions.subspan(Begin, std::min(ShardSize, Functions.size() - Begin));
+        Shard.Name = "shard" + std::to_string(Shards.size() - 1) + ".o";
+    }
+
+    if (Threads == 0) {
+        Threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    Threads = std::min<std::size_t>(Threads, Shards.size());
+    std::atomic<std::size_t> NextShard = 0;
+    {
+        std::vector<std::jthread> Workers;
+        for (unsigned I = 0; I < Threads; ++I) {
+            Workers.emplace_back([&] {
+                for (auto Index = NextShard++; Index < Shards.size(); Index = NextShard++) {
+                    emitShard(Shards[Index], SemanInfo, Options);
+                }
+            });
+        }
+    }
+
+    bool Success = true;
+    for (const auto& Shard : Shards) {
+        if (!Shard.Error.empty()) {
+            llvm::errs() << Shard.Error << "\n";
+            Success = false;
+        }
+    }
+    return Success && writeArchive(Path, Shards);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "CodeGenOptions.h"
+#include <string>
+
+class Module;
+class Seman;
+
+// Splits the functions of Module into shards of FunctionsPerShard in
+// declaration order. Each shard is generated, optimized and compiled to an
+// object in its own LLVMContext on one of Threads worker threads (0 means one
+// per hardware thread). Calls into other shards become external declarations.
+// The objects are written as members of a static archive at Path. Shard
+// boundaries depend only on the input, so the archive is byte-identical for
+// any thread count. Diagnostics go to stderr.
+bool emitParallel(const Module& Module, Seman& SemanInfo, const CodeGenOptions& Options, unsigned Threads,
+                  const std::string& Path);
\ No newline at end of file
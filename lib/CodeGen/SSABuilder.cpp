@@ -0,0 +1,108 @@
+#include "SSABuilder.h"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+void SSABuilder::writeVariable(std::uint32_t Var, llvm::BasicBlock* Block, llvm::Value* Value) {
+    CurrentDefs[{ Block, Var }] = Value;
+}
+
+llvm::Value* SSABuilder::readVariable(std::uint32_t Var, llvm::BasicBlock* Block) {
+    const auto Iter = CurrentDefs.find({ Block, Var });
+    if (Iter != CurrentDefs.end()) {
+        return Iter->second;
+    }
+    return readVariableRecursive(Var, Block);
+}
+
+void SSABuilder::sealBlock(llvm::BasicBlock* Block) {
+    const auto Iter = IncompletePhis.find(Block);
+    if (Iter != IncompletePhis.end()) {
+        const auto Phis = std::move(Iter->second);
+        IncompletePhis.erase(Iter);
+        for (const auto& [Var, Phi] : Phis) {
+            addPhiOperands(Var, Phi);
+        }
+    }
+    SealedBlocks.insert(Block);
+}
+
+void SSABuilder::reset() {
+    CurrentDefs.clear();
+    IncompletePhis.clear();
+    SealedBlocks.clear();
+}
+
+llvm::Value* SSABuilder::readVariableRecursive(std::uint32_t Var, llvm::BasicBlock* Block) {
+    llvm::Value* Value = nullptr;
+    if (!SealedBlocks.contains(Block)) {
+        const auto Phi = createPhi(Var, Block);
+        IncompletePhis[Block].emplace_back(Var, Phi);
+        Value = Phi;
+    } else if (const auto Pred = Block->getSinglePredecessor()) {
+        Value = readVariable(Var, Pred);
+    } else if (llvm::pred_empty(Block)) {
+        // Unreachable code, e.g. the block after a return.
+        Value = llvm::UndefValue::get(VariableTypes.lookup(Var));
+    } else {
+        // Define the phi before reading the operands to break cycles.
+        const auto Phi = createPhi(Var, Block);
+        writeVariable(Var, Block, Phi);
+        Value = addPhiOperands(Var, Phi);
+    }
+    writeVariable(Var, Block, Value);
+    return Value;
+}
+
+llvm::PHINode* SSABuilder::createPhi(std::uint32_t Var, llvm::BasicBlock* Block) {
+    const auto Ty = VariableTypes.lookup(Var);
+    if (const auto FirstNonPhi = Block->getFirstNonPHI()) {
+        return llvm::PHINode::Create(Ty, 2, "", FirstNonPhi);
+    }
+    return llvm::PHINode::Create(Ty, 2, "", Block);
+}
+
+llvm::Value* SSABuilder::addPhiOperands(std::uint32_t Var, llvm::PHINode* Phi) {
+    const auto Block = Phi->getParent();
+    for (const auto Pred : llvm::predecessors(Block)) {
+        Phi->addIncoming(readVariable(Var, Pred), Pred);
+    }
+    return tryRemoveTrivialPhi(Phi);
+}
+
+llvm::Value* SSABuilder::tryRemoveTrivialPhi(llvm::PHINode* Phi) {
+    llvm::Value* Same = nullptr;
+    for (const auto& Incoming : Phi->incoming_values()) {
+        const auto Operand = Incoming.get();
+        if (Operand == Same || Operand == Phi) {
+            continue;
+        }
+        if (Same != nullptr) {
+            return Phi;
+        }
+        Same = Operand;
+    }
+    if (Same == nullptr) {
+        Same = llvm::UndefValue::get(Phi->getType());
+    }
+
+    llvm::SmallVector<llvm::WeakTrackingVH, 8> Users;
+    for (const auto User : Phi->users()) {
+        if (User != Phi && llvm::isa<llvm::PHINode>(User)) {
+            Users.emplace_back(User);
+        }
+    }
+    Phi->replaceAllUsesWith(Same);
+    Phi->eraseFromParent();
+
+    // Removing this phi may have made its users trivial. A handle is null or
+    // no longer a phi if an earlier iteration already folded it.
+    for (const auto& User : Users) {
+        if (const auto UserPhi = llvm::dyn_cast_or_null<llvm::PHINode>(User)) {
+            tryRemoveTrivialPhi(UserPhi);
+        }
+    }
+    return Same;
+}
\ No newline at end of file
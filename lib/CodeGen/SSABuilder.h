@@ -0,0 +1,44 @@
+#pragma once
+#include "Utils/DenseTable.h"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/ValueHandle.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+    class BasicBlock;
+    class PHINode;
+    class Type;
+    class Value;
+}
+
+// On-the-fly SSA construction after Braun et al., "Simple and Efficient
+// Construction of Static Single Assignment Form" (CC 2013). Variables are
+// name IDs. A block may only be sealed once all of its predecessors exist;
+// reads in unsealed blocks create operandless phis that sealing completes.
+class SSABuilder {
+public:
+    void declareVariable(std::uint32_t Var, llvm::Type* Ty) { VariableTypes[Var] = Ty; }
+    bool isVariable(std::uint32_t Var) const { return VariableTypes.lookup(Var) != nullptr; }
+
+    void writeVariable(std::uint32_t Var, llvm::BasicBlock* Block, llvm::Value* Value);
+    llvm::Value* readVariable(std::uint32_t Var, llvm::BasicBlock* Block);
+    void sealBlock(llvm::BasicBlock* Block);
+    // Drops the per-block state of the previous function.
+    void reset();
+
+private:
+    llvm::Value* readVariableRecursive(std::uint32_t Var, llvm::BasicBlock* Block);
+    llvm::PHINode* createPhi(std::uint32_t Var, llvm::BasicBlock* Block);
+    llvm::Value* addPhiOperands(std::uint32_t Var, llvm::PHINode* Phi);
+    llvm::Value* tryRemoveTrivialPhi(llvm::PHINode* Phi);
+
+    DenseTable<llvm::Type*> VariableTypes;
+    // Weak tracking handles follow replaceAllUsesWith, so definitions stay
+    // valid when a trivial phi is folded away.
+    llvm::DenseMap<std::pair<llvm::BasicBlock*, std::uint32_t>, llvm::WeakTrackingVH> CurrentDefs;
+    llvm::DenseMap<llvm::BasicBlock*, std::vector<std::pair<std::uint32_t, llvm::PHINode*>>> IncompletePhis;
+    llvm::SmallPtrSet<llvm::BasicBlock*, 16> SealedBlocks;
+};
\ No newline at end of file
@@ -66,8 +66,9 @@ void TypeEmitter::visit(const UnresolvedType& Ty) {
 }
 
 llvm::Type* TypeEmitter::emit(const Type& Ty) {
-    if (Types.contains(&Ty)) {
-        return Types[&Ty];
+    if (const auto Cached = Types.lookup(Ty.getID())) {
+        return Cached;
     }
-    return Types[&Ty] = doVisit(Ty);
+    const auto Emitted = doVisit(Ty);
+    return Types[Ty.getID()] = Emitted;
 }
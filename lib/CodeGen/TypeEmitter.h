@@ -1,7 +1,7 @@
 #pragma once
 #include "AST/TypeVisitor.h"
+#include "Utils/DenseTable.h"
 #include "Utils/VisitorBase.h"
-#include <map>
 
 class Seman;
 
@@ -26,5 +26,5 @@ public:
 private:
     llvm::LLVMContext& Context;
     Seman& SemanInfo;
-    std::map<const Type*, llvm::Type*> Types;
+    DenseTable<llvm::Type*> Types;
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "CharScanner.h"
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#define UNL_SCANNER_AVX2
+#define UNL_SCANNER_SIMD
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNL_SCANNER_SSE2
+#define UNL_SCANNER_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr bool isWhitespace(char Chr) {
+        return Chr == ' ' || Chr == '\t' || Chr == '\n' || Chr == '\r';
+    }
+
+    constexpr bool isDigit(char Chr) {
+        return Chr >= '0' && Chr <= '9';
+    }
+
+    constexpr bool isIdentifierChar(char Chr) {
+        const auto Lower = static_cast<char>(Chr | 0x20);
+        return (Lower >= 'a' && Lower <= 'z') || isDigit(Chr) || Chr == '_';
+    }
+
+#if defined(UNL_SCANNER_AVX2)
+    using Block = __m256i;
+    constexpr std::size_t BlockSize = 32;
+
+    Block load(const char* Ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Ptr)); }
+    Block splat(char Chr) { return _mm256_set1_epi8(Chr); }
+    Block equal(Block Lhs, Block Rhs) { return _mm256_cmpeq_epi8(Lhs, Rhs); }
+    Block greater(Block Lhs, Block Rhs) { return _mm256_cmpgt_epi8(Lhs, Rhs); }
+    Block both(Block Lhs, Block Rhs) { return _mm256_and_si256(Lhs, Rhs); }
+    Block either(Block Lhs, Block Rhs) { return _mm256_or_si256(Lhs, Rhs); }
+    std::uint32_t mask(Block Value) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(Value)); }
+#elif defined(UNL_SCANNER_SSE2)
+    using Block = __m128i;
+    constexpr std::size_t BlockSize = 16;
+
+    Block load(const char* Ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Ptr)); }
+    Block splat(char Chr) { return _mm_set1_epi8(Chr); }
+    Block equal(Block Lhs, Block Rhs) { return _mm_cmpeq_epi8(Lhs, Rhs); }
+    Block greater(Block Lhs, Block Rhs) { return _mm_cmpgt_epi8(Lhs, Rhs); }
+    Block both(Block Lhs, Block Rhs) { return _mm_and_si128(Lhs, Rhs); }
+    Block either(Block Lhs, Block Rhs) { return _mm_or_si128(Lhs, Rhs); }
+    std::uint32_t mask(Block Value) { return static_cast<std::uint32_t>(_mm_movemask_epi8(Value)); }
+#endif
+
+#if defined(UNL_SCANNER_SIMD)
+    constexpr std::uint32_t FullMask = BlockSize == 32 ? ~std::uint32_t{0} : (std::uint32_t{1} << BlockSize) - 1;
+
+    // Bytes >= 0x80 compare as negative, so they never fall inside an ASCII range.
+    Block inRange(Block Chrs, char Low, char High) {
+        return both(greater(Chrs, splat(static_cast<char>(Low - 1))), greater(splat(static_cast<char>(High + 1)), Chrs));
+    }
+
+    Block whitespaceMask(Block Chrs) {
+        return either(either(equal(Chrs, splat(' ')), equal(Chrs, splat('\t'))),
+                      either(equal(Chrs, splat('\n')), equal(Chrs, splat('\r'))));
+    }
+
+    Block digitMask(Block Chrs) {
+        return inRange(Chrs, '0', '9');
+    }
+
+    Block identifierMask(Block Chrs) {
+        const auto Lower = either(Chrs, splat(0x20));
+        return either(either(inRange(Lower, 'a', 'z'), digitMask(Chrs)), equal(Chrs, splat('_')));
+    }
+#endif
+
+#if defined(UNL_SCANNER_SIMD)
+    template <typename Pred>
+    std::size_t scanBlocks(std::string_view Source, std::size_t At, Pred MatchBlock) {
+        while (At + BlockSize <= Source.size()) {
+            const auto Matched = mask(MatchBlock(load(Source.data() + At)));
+            if (Matched != FullMask) {
+                return At + std::countr_one(Matched);
+            }
+            At += BlockSize;
+        }
+        return At;
+    }
+#endif
+
+    template <typename Pred>
+    std::size_t scanTail(std::string_view Source, std::size_t At, Pred MatchChar) {
+        while (At < Source.size() && MatchChar(Source[At])) {
+            At++;
+        }
+        return At;
+    }
+}
+
+std::size_t scanWhitespace(std::string_view Source, std::size_t At) {
+#if defined(UNL_SCANNER_SIMD)
+    At = scanBlocks(Source, At, whitespaceMask);
+#endif
+    return scanTail(Source, At, isWhitespace);
+}
+
+std::size_t scanIdentifier(std::string_view Source, std::size_t At) {
+#if defined(UNL_SCANNER_SIMD)
+    At = scanBlocks(Source, At, identifierMask);
+#endif
+    return scanTail(Source, At, isIdentifierChar);
+}
+
+std::size_t scanDigits(std::string_view Source, std::size_t At) {
+#if defined(UNL_SCANNER_SIMD)
+    At = scanBlocks(Source, At, digitMask);
+#endif
+    return scanTail(Source, At, isDigit);
+}
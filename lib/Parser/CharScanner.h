@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// Each scanner returns the index of the first character at or after At
+// that does not belong to the scanned class, or Source.size().
+// Blocks of 32 (AVX2) or 16 (SSE2) bytes are tested at once when the
+// target supports it; the remaining tail is scanned one byte at a time.
+
+std::size_t scanWhitespace(std::string_view Source, std::size_t At);
+std::size_t scanIdentifier(std::string_view Source, std::size_t At);
+std::size_t scanDigits(std::string_view Source, std::size_t At);
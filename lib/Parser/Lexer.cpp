@@ -1,8 +1,9 @@
 #include "Lexer.h"
 #include "Token.h"
+#include "CharScanner.h"
 #include <string>
 #include <ranges>
-#include <cctype>
+#include <algorithm>
 #include <utility>
 #include <cassert>
 
@@ -15,23 +16,12 @@ namespace {
 }
 
 Token Lexer::nextToken() {
+    At = scanWhitespace(Source, At);
     Size = 0;
     auto Kind = TokenKind::Eof;
     switch (nextChar()) {
         case '\0':
             break;
-        case '\r':
-            return nextToken();
-        case '\n': {
-            LineNum++;
-            Column = 0;
-            return nextToken();
-        }
-        case ' ':
-        case '\t': {
-            Column++;
-            return nextToken();
-        }
         case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i': case 'j':
         case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't':
         case 'u': case 'v': case 'w': case 'x': case 'y': case 'z': case 'A': case 'B': case 'C': case 'D':
@@ -138,7 +128,7 @@ Token Lexer::nextToken() {
 }
 
 bool Lexer::tryConsume(char Chr) {
-    if (Source[At] == Chr) {
+    if (!isEof() && Source[At] == Chr) {
         Size++;
         At++;
         return true;
@@ -147,24 +137,23 @@ bool Lexer::tryConsume(char Chr) {
 }
 
 char Lexer::nextChar() {
-    Size++;
     if (isEof()) {
         return 0;
     }
+    Size++;
     return Source[At++];
 }
 
 
 Token Lexer::makeToken(TokenKind Kind) {
-    Token Ret = { Kind, {LineNum, Column}, Source.substr(At - Size, Size)};
-    Column += Size;
-    return Ret;
+    const auto Start = At - Size;
+    return { Kind, { static_cast<std::uint32_t>(Start) }, Source.substr(Start, Size) };
 }
 
 Token Lexer::readIdentifierOrKeyword() {
-    while (!isEof() && (std::isalnum(Source[At]) || Source[At] == '_')) {
-        nextChar();
-    }
+    const auto End = scanIdentifier(Source, At);
+    Size += End - At;
+    At = End;
     auto Buffer = Source.substr(At - Size, Size);
     const auto Iter = std::ranges::find_if(Keywords, [&](auto Kind) {
         return Buffer == kindToString(Kind);
@@ -176,8 +165,8 @@ Token Lexer::readIdentifierOrKeyword() {
 }
 
 Token Lexer::readInteger() {
-    while (!isEof() && std::isdigit(Source[At])) {
-        nextChar();
-    }
+    const auto End = scanDigits(Source, At);
+    Size += End - At;
+    At = End;
     return makeToken(TokenKind::Integer);
 }
@@ -5,7 +5,8 @@
 
 class Lexer {
 public:
-    explicit Lexer(std::string_view Source) : Source(Source) {}
+    // Starts lexing at offset At, so tokens keep their offsets in the whole of Source.
+    explicit Lexer(std::string_view Source, size_t At = 0) : Source(Source), At(At) {}
     Token nextToken();
     [[nodiscard]] bool isEof() const { return At >= Source.length(); }
 private:
@@ -16,5 +17,5 @@ private:
     [[nodiscard]] Token readInteger();
     size_t Size;
     std::string_view Source;
-    size_t LineNum = 1, Column = 0, At = 0;
+    size_t At = 0;
 };
\ No newline at end of file
@@ -1,26 +1,158 @@
 #include "Parser.h"
 
 #include "Utils/ErrorReporter.h"
+#include "Utils/TimeReport.h"
 #include "AST/Decl.h"
 #include "AST/Stmt.h"
 #include "AST/Module.h"
 #include <format>
 #include <cassert>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+std::unique_ptr<Module> Parser::parseSourceFile(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext, const ParseOptions& Options) {
+    TimeScope Scope("parse");
+    std::unique_ptr<Module> Module;
+    if (Options.Threads == 1) {
+        Parser P(Source, Reporter, Options);
+        Module = P.parseModule(std::move(TyContext));
+    } else {
+        Module = parseModuleParallel(Source, Reporter, std::move(TyContext), Options);
+    }
+    TimeReport::get().addCounter("AST nodes", Module->getNumNodes());
+    TimeReport::get().addCounter("AST arena bytes", Module->getBytesAllocated());
+    return Module;
+}
+
+std::optional<std::vector<TokenRange>> Parser::findTopLevelDecls(const TokenBuffer& Tokens) {
+    std::vector<TokenRange> Ranges;
+    // The last token is always Eof.
+    const auto NumTokens = Tokens.size() - 1;
+    std::size_t Index = 0;
+    while (Index < NumTokens) {
+        if (Tokens.getKind(Index) != TokenKind::Function && Tokens.getKind(Index) != TokenKind::Struct) {
+            return std::nullopt;
+        }
+        const auto Begin = Index;
+        std::size_t Depth = 0;
+        for (; Index < NumTokens; Index++) {
+            const auto Kind = Tokens.getKind(Index);
+            if (Kind == TokenKind::LeftBrace) {
+                Depth++;
+            } else if (Kind == TokenKind::RightBrace) {
+                if (Depth == 0) {
+                    return std::nullopt;
+                }
+                if (--Depth == 0) {
+                    break;
+                }
+            }
+        }
+        if (Index == NumTokens) {
+            return std::nullopt;
+        }
+        Ranges.emplace_back(Begin, ++Index);
+    }
+    return Ranges;
+}
+
+AstPtr<Declaration> Parser::parseDeclaration(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, TokenRange Range,
+                                             std::shared_ptr<TypeContext> TyContext, Arena& NodeArena) {
+    Parser P(Source, Reporter, Tokens, std::move(TyContext), false);
+    P.NodeArena = &NodeArena;
+    return P.parseInRange(Range, &Parser::parseTopLevelDecl);
+}
+
+AstPtr<Statement> Parser::parseFunctionBody(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, TokenRange Range,
+                                            std::shared_ptr<TypeContext> TyContext, Arena& NodeArena) {
+    // A signature has no braces, so the body starts at the first one.
+    auto Begin = Range.first;
+    while (Begin < Range.second && Tokens.getKind(Begin) != TokenKind::LeftBrace) {
+        Begin++;
+    }
+    Parser P(Source, Reporter, Tokens, std::move(TyContext), false);
+    P.NodeArena = &NodeArena;
+    return P.parseInRange({ Begin, Range.second }, &Parser::parseCompoundStmt);
+}
 
-AstPtr<Module> Parser::parseSourceFile(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext) {
-    Parser P(Source, Reporter);
-    return P.parseModule(std::move(TyContext));
+void Parser::parseFunctionBody(Module& Module, FunctionDecl& Function, ErrorReporter& Reporter) {
+    assert(!Function.isBodyParsed());
+    TraceScope Span("parse body", Function.getName());
+    Parser P(Module.getSourceFile(), Reporter, Module.TyContext, *Module.NodeArenas.front(), Function.getBodyStart());
+    Function.setBody(P.parseCompoundStmt());
 }
 
-Parser::Parser(SourceFile& Source, ErrorReporter& Reporter) : Reporter(Reporter), Source(Source),
-                                                             Lex(Source.getSourceCode()), CurTok(Lex.nextToken()) {
+Parser::Parser(SourceFile& Source, ErrorReporter& Reporter, const ParseOptions& Options) : Reporter(Reporter), Source(Source),
+    Lex(Source.getSourceCode()),
+    OwnedTokens(Options.PreLex ? std::make_optional<TokenBuffer>(Source.getSourceCode()) : std::nullopt),
+    Tokens(OwnedTokens ? &*OwnedTokens : nullptr),
+    LazyBodies(Options.LazyBodies),
+    CurTok(lexToken()) {
+}
+
+Parser::Parser(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, std::shared_ptr<TypeContext> TyContext, bool LazyBodies) :
+    Reporter(Reporter), TyContext(std::move(TyContext)), Source(Source), Lex(Source.getSourceCode()), Tokens(&Tokens),
+    LazyBodies(LazyBodies), CurTok(lexToken()) {
+}
+
+Parser::Parser(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext, Arena& NodeArena, SourceLoc Start) :
+    Reporter(Reporter), TyContext(std::move(TyContext)), OwnedArena(nullptr), NodeArena(&NodeArena), Source(Source),
+    Lex(Source.getSourceCode(), Start.Offset), Tokens(nullptr), CurTok(lexToken()) {
+}
+
+std::unique_ptr<Module> Parser::parseModuleParallel(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext, const ParseOptions& Options) {
+    const TokenBuffer Tokens(Source.getSourceCode());
+    const auto Ranges = findTopLevelDecls(Tokens);
+    auto Threads = Options.Threads;
+    if (Threads == 0) {
+        Threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (!Ranges || Ranges->size() < 2) {
+        return Parser(Source, Reporter, Tokens, TyContext, Options.LazyBodies).parseModule(TyContext);
+    }
+
+    Threads = std::min<std::size_t>(Threads, Ranges->size());
+    std::vector<AstPtr<Declaration>> Nodes(Ranges->size());
+    std::vector<std::unique_ptr<Arena>> NodeArenas(Threads);
+    std::atomic<std::size_t> NextDecl = 0;
+    std::atomic<bool> Failed = false;
+    {
+        std::vector<std::jthread> Workers;
+        for (unsigned I = 0; I < Threads; ++I) {
+            Workers.emplace_back([&, I] {
+                // Diagnostics are dropped; the serial parse below reports them.
+                std::ostringstream Discarded;
+                ErrorReporter WorkerReporter(Discarded);
+                Parser P(Source, WorkerReporter, Tokens, TyContext, Options.LazyBodies);
+                for (auto Index = NextDecl++; Index < Ranges->size() && !Failed; Index = NextDecl++) {
+                    TraceScope Span("parse declaration");
+                    Nodes[Index] = P.parseInRange((*Ranges)[Index], &Parser::parseTopLevelDecl);
+                    if (Nodes[Index] == nullptr) {
+                        Failed = true;
+                    }
+                }
+                NodeArenas[I] = std::move(P.OwnedArena);
+            });
+        }
+    }
+
+    if (Failed) {
+        // Error recovery may read past a declaration's closing brace, so only a serial parse is faithful. The
+        // types and names the workers created stay in TyContext unused.
+        return Parser(Source, Reporter, Tokens, TyContext, Options.LazyBodies).parseModule(TyContext);
+    }
+    return std::make_unique<Module>(std::move(Nodes), std::move(TyContext), Source, std::move(NodeArenas));
 }
 
 template <typename... T>
 std::optional<Token> Parser::consumeToken(T... Args) {
     if (CurTok.is(Args...)) {
         auto Ret = CurTok;
-        CurTok = Lex.nextToken();
+        CurTok = lexToken();
         return Ret;
     }
     return std::nullopt;
@@ -46,28 +178,61 @@ void Parser::expectSemicolon() {
 
 IdentifierSymbol Parser::expectIdentifier() {
     const auto Tok = expectToken(TokenKind::Identifier);
-    return { std::string(Tok.getValue()), Tok.getRange() };
+    return { TyContext->getIdentifiers().get(Tok.getValue()), Tok.getRange() };
 }
 
 Token Parser::advanceToken() {
     auto Tok = CurTok;
-    CurTok = Lex.nextToken();
+    CurTok = lexToken();
     return Tok;
 }
 
-AstPtr<Module> Parser::parseModule(std::shared_ptr<TypeContext> TypeContext) {
+Token Parser::lexToken() {
+    if (Tokens) {
+        if (NextTokIndex >= EndTokIndex) {
+            NextTokIndex++;
+            return { TokenKind::Eof, Tokens->getToken(EndTokIndex).getStart(), {} };
+        }
+        return Tokens->getToken(NextTokIndex++);
+    }
+    return Lex.nextToken();
+}
+
+std::unique_ptr<Module> Parser::parseModule(std::shared_ptr<TypeContext> TypeContext) {
     TyContext = std::move(TypeContext);
     std::vector<AstPtr<Declaration>> Nodes;
     while (!CurTok.is(TokenKind::Eof)) {
-        if (CurTok.is(TokenKind::Function)) {
-            Nodes.push_back(parseFunctionDecl());
-        } else if (CurTok.is(TokenKind::Struct)) {
-            Nodes.push_back(parseStructDecl());
-        } else {
-            assert(false);
-        }
+        Nodes.push_back(parseTopLevelDecl());
+    }
+    std::vector<std::unique_ptr<Arena>> NodeArenas;
+    NodeArenas.push_back(std::move(OwnedArena));
+    return std::make_unique<Module>(std::move(Nodes), std::move(TyContext), Source, std::move(NodeArenas));
+}
+
+AstPtr<Declaration> Parser::parseTopLevelDecl() {
+    if (CurTok.is(TokenKind::Function)) {
+        return parseFunctionDecl();
+    }
+    if (CurTok.is(TokenKind::Struct)) {
+        return parseStructDecl();
+    }
+    assert(false);
+    return nullptr;
+}
+
+// Parses the tokens in Range with Parse. Returns nullptr if it reports an error or does not end exactly at the
+// end of Range, since the serial parser might then have read them differently.
+template <typename T>
+AstPtr<T> Parser::parseInRange(TokenRange Range, AstPtr<T> (Parser::*Parse)()) {
+    const auto NumErrors = Reporter.getNumErrors();
+    NextTokIndex = Range.first;
+    EndTokIndex = Range.second;
+    CurTok = lexToken();
+    const auto Node = (this->*Parse)();
+    if (Reporter.getNumErrors() != NumErrors || NextTokIndex != Range.second + 1) {
+        return nullptr;
     }
-    return std::make_unique<Module>(std::move(Nodes), std::move(TyContext), Source);
+    return Node;
 }
 
 AstPtr<Declaration> Parser::parseFunctionDecl() {
@@ -77,16 +242,41 @@ AstPtr<Declaration> Parser::parseFunctionDecl() {
     std::vector<FunctionDecl::Param> Params;
     if (!CurTok.is(TokenKind::RightParen)) {
         const auto ParamName = expectIdentifier();
-        Params.emplace_back(ParamName, parseTypeAnnotation().getType());
+        Params.emplace_back(ParamName, TyContext->allocateNameID(), parseTypeAnnotation().getType());
     }
     while (!consumeToken(TokenKind::RightParen)) {
         expectToken(TokenKind::Comma);
         const auto ParamName = expectIdentifier();
-        Params.emplace_back(ParamName, parseTypeAnnotation().getType());
+        Params.emplace_back(ParamName, TyContext->allocateNameID(), parseTypeAnnotation().getType());
     }
     auto RetType = parseTypeAnnotation();
+    if (LazyBodies && CurTok.is(TokenKind::LeftBrace)) {
+        const auto BodyStart = CurTok.getStart();
+        if (!skipBody()) {
+            const auto Message = std::format("expected '{}', found '{}'", kindToString(TokenKind::RightBrace), kindToString(TokenKind::Eof));
+            Reporter.error(Source, CurTok.getRange(), Message);
+        }
+        return create<FunctionDecl>(Name, TyContext->allocateNameID(), RetType.getType(), NodeArena->copyList(Params), BodyStart);
+    }
     AstPtr<Statement> Body = parseCompoundStmt();
-    return std::make_unique<FunctionDecl>(Name, RetType.getType(), std::move(Params), std::move(Body));
+    return create<FunctionDecl>(Name, TyContext->allocateNameID(), RetType.getType(), NodeArena->copyList(Params), std::move(Body));
+}
+
+// Consumes a brace-delimited block without building any nodes. Returns false if the file ends first.
+bool Parser::skipBody() {
+    std::size_t Depth = 0;
+    do {
+        if (CurTok.is(TokenKind::Eof)) {
+            return false;
+        }
+        if (CurTok.is(TokenKind::LeftBrace)) {
+            Depth++;
+        } else if (CurTok.is(TokenKind::RightBrace)) {
+            Depth--;
+        }
+        advanceToken();
+    } while (Depth > 0);
+    return true;
 }
 
 AstPtr<Declaration> Parser::parseStructDecl() {
@@ -97,15 +287,16 @@ AstPtr<Declaration> Parser::parseStructDecl() {
     auto FirstFieldIdentifier = expectIdentifier();
     StructDeclField Field = {
         FirstFieldIdentifier,
+        TyContext->allocateNameID(),
         parseTypeAnnotation().getType()
     };
     Fields.push_back(std::move(Field));
     while (consumeToken(TokenKind::Comma)) {
         auto FieldName = expectIdentifier();
-        Fields.emplace_back(FieldName, parseTypeAnnotation().getType());
+        Fields.emplace_back(FieldName, TyContext->allocateNameID(), parseTypeAnnotation().getType());
     }
     expectToken(TokenKind::RightBrace);
-    return std::make_unique<StructDecl>(Name, std::move(Fields));
+    return create<StructDecl>(Name, TyContext->allocateNameID(), NodeArena->copyList(Fields));
 }
 
 AstPtr<Statement> Parser::parseStmt() {
@@ -131,7 +322,7 @@ AstPtr<Statement> Parser::parseCompoundStmt() {
     while (!consumeToken(TokenKind::RightBrace)) {
         Body.push_back(parseStmt());
     }
-    return std::make_unique<CompoundStmt>(std::move(Body));
+    return create<CompoundStmt>(NodeArena->copyList(Body));
 }
 
 AstPtr<Statement> Parser::parseWhileStmt() {
@@ -140,7 +331,7 @@ AstPtr<Statement> Parser::parseWhileStmt() {
     auto Cond = parseExpr();
     expectToken(TokenKind::RightParen);
     auto Body = parseStmt();
-    return std::make_unique<WhileStmt>(std::move(Cond), std::move(Body));
+    return create<WhileStmt>(std::move(Cond), std::move(Body));
 }
 
 AstPtr<Statement> Parser::parseIfStmt() {
@@ -153,7 +344,7 @@ AstPtr<Statement> Parser::parseIfStmt() {
     if (consumeToken(TokenKind::Else)) {
         FalseBlock = parseStmt();
     }
-    return std::make_unique<IfStmt>(std::move(Cond), std::move(TrueBlock), std::move(FalseBlock));
+    return create<IfStmt>(std::move(Cond), std::move(TrueBlock), std::move(FalseBlock));
 }
 
 AstPtr<Statement> Parser::parseLetStmt() {
@@ -166,7 +357,7 @@ AstPtr<Statement> Parser::parseLetStmt() {
         Value = parseExpr();
     }
     expectSemicolon();
-    return std::make_unique<LetStmt>(std::move(Name), Type, std::move(Value));
+    return create<LetStmt>(std::move(Name), TyContext->allocateNameID(), Type, std::move(Value));
 }
 
 AstPtr<Statement> Parser::parseReturnStmt() {
@@ -176,7 +367,7 @@ AstPtr<Statement> Parser::parseReturnStmt() {
         Expr = parseExpr();
     }
     expectSemicolon();
-    return std::make_unique<ReturnStmt>(std::move(Expr));
+    return create<ReturnStmt>(std::move(Expr));
 }
 
 AstPtr<Statement> Parser::parseExpressionOrAssignStmt() {
@@ -186,7 +377,7 @@ AstPtr<Statement> Parser::parseExpressionOrAssignStmt() {
         return parseAssignStmt(std::move(Expr));
     }
     expectSemicolon();
-    return std::make_unique<ExpressionStmt>(std::move(Expr));
+    return create<ExpressionStmt>(std::move(Expr));
 }
 
 AstPtr<Statement> Parser::parseAssignStmt(AstPtr<Expression> Left) {
@@ -194,7 +385,7 @@ AstPtr<Statement> Parser::parseAssignStmt(AstPtr<Expression> Left) {
     auto Right = parseExpr();
     expectSemicolon();
 
-    return std::make_unique<AssignStmt>(std::move(Left), std::move(Right));
+    return create<AssignStmt>(std::move(Left), std::move(Right));
 }
 
 AstPtr<Expression> Parser::parseExpr() {
@@ -202,49 +393,37 @@ AstPtr<Expression> Parser::parseExpr() {
 }
 
 namespace {
-    constexpr auto binOpPrecedence(TokenKind Kind) {
-        switch (Kind) {
-            case TokenKind::PipePipe:
-                return 0;
-            case TokenKind::AmpAmp:
-                return 1;
-            case TokenKind::Pipe:
-                return 2;
-            case TokenKind::Caret:
-                return 3;
-            case TokenKind::EqualEqual:
-            case TokenKind::NotEqual:
-                return 4;
-            case TokenKind::LessEqual:
-            case TokenKind::Less:
-            case TokenKind::Greater:
-            case TokenKind::GreaterEqual:
-                return 5;
-            case TokenKind::LessLess:
-            case TokenKind::GreaterGreater:
-                return 6;
-            case TokenKind::Plus:
-            case TokenKind::Minus:
-                return 7;
-            case TokenKind::Star:
-            case TokenKind::Slash:
-            case TokenKind::Percent:
-                return 8;
-            default:
-                return -1;
-        }
+    // Left binding power of every token kind; 0 means the token does not continue a binary expression.
+    constexpr auto BindingPowers = [] {
+        std::array<std::uint8_t, std::to_underlying(TokenKind::Eof) + 1> Powers{};
+        const auto set = [&](std::uint8_t Power, auto... Kinds) {
+            ((Powers[std::to_underlying(Kinds)] = Power), ...);
+        };
+        set(1, TokenKind::PipePipe);
+        set(2, TokenKind::AmpAmp);
+        set(3, TokenKind::Pipe);
+        set(4, TokenKind::Caret);
+        set(5, TokenKind::EqualEqual, TokenKind::NotEqual);
+        set(6, TokenKind::LessEqual, TokenKind::Less, TokenKind::Greater, TokenKind::GreaterEqual);
+        set(7, TokenKind::LessLess, TokenKind::GreaterGreater);
+        set(8, TokenKind::Plus, TokenKind::Minus);
+        set(9, TokenKind::Star, TokenKind::Slash, TokenKind::Percent);
+        return Powers;
+    }();
+
+    constexpr std::uint8_t bindingPower(TokenKind Kind) {
+        return BindingPowers[std::to_underlying(Kind)];
     }
 }
 
-AstPtr<Expression> Parser::parseBinaryExpr(int Prec) {
-    if (Prec > binOpPrecedence(TokenKind::Star)) {
-        return parseCastExpr();
-    }
-    auto Expr = parseBinaryExpr(Prec + 1);
-    while (binOpPrecedence(CurTok.getKind()) == Prec) {
+// Operators are left associative, so the right operand only absorbs operators binding strictly tighter.
+// Recursion depth grows with the number of distinct precedence increases instead of the number of levels.
+AstPtr<Expression> Parser::parseBinaryExpr(std::uint8_t MinPower) {
+    auto Expr = parseCastExpr();
+    while (bindingPower(CurTok.getKind()) > MinPower) {
         const auto Tok = advanceToken();
-        auto Right = parseBinaryExpr(Prec + 1);
-        Expr = std::make_unique<BinaryOpExpr>(Tok.getKind(), std::move(Expr), std::move(Right));
+        auto Right = parseBinaryExpr(bindingPower(Tok.getKind()));
+        Expr = create<BinaryOpExpr>(Tok.getKind(), std::move(Expr), std::move(Right));
     }
     return Expr;
 }
@@ -253,7 +432,7 @@ AstPtr<Expression> Parser::parseCastExpr() {
     AstPtr<Expression> Expr = parseUnaryExpr();
     if (consumeToken(TokenKind::As)) {
         auto Type = parseType();
-        Expr = std::make_unique<CastExpr>(Type, std::move(Expr));
+        Expr = create<CastExpr>(Type, std::move(Expr));
     }
     return Expr;
 }
@@ -262,7 +441,7 @@ AstPtr<Expression> Parser::parseUnaryExpr() {
     const auto Tok = consumeToken(TokenKind::Plus, TokenKind::Minus, TokenKind::Tilde, TokenKind::Star, TokenKind::Amp, TokenKind::ExclMark);
     if (Tok) {
         auto Expr = parsePostFixExpr();
-        return std::make_unique<UnaryOpExpr>(Tok->getStart(), Tok->getKind(), std::move(Expr));
+        return create<UnaryOpExpr>(Tok->getStart(), Tok->getKind(), std::move(Expr));
     }
     return parsePostFixExpr();
 }
@@ -274,16 +453,16 @@ AstPtr<Expression> Parser::parsePostFixExpr() {
         if (CurTok.is(TokenKind::Dot)) {
             advanceToken();
             auto Identifier = expectIdentifier();
-            Expr = std::make_unique<DotExpr>(std::move(Expr), Identifier);
+            Expr = create<DotExpr>(std::move(Expr), Identifier);
         } else if (CurTok.is(TokenKind::LeftParen)) {
             auto Args = parseCallArgs();
             const auto RParen = expectToken(TokenKind::RightParen);
-            Expr = std::make_unique<FunctionCallExpr>(std::move(Expr), std::move(Args), RParen.getEnd());
+            Expr = create<FunctionCallExpr>(std::move(Expr), NodeArena->copyList(Args), RParen.getEnd());
         } else if (CurTok.is(TokenKind::LeftSqrBrace)) {
             advanceToken();
             auto Subscript = parseExpr();
             const auto RSqrBrace = expectToken(TokenKind::RightSqrBrace);
-            Expr = std::make_unique<SubscriptExpr>(std::move(Expr), std::move(Subscript), RSqrBrace.getEnd());
+            Expr = create<SubscriptExpr>(std::move(Expr), std::move(Subscript), RSqrBrace.getEnd());
         } else {
             break;
         }
@@ -309,19 +488,19 @@ AstPtr<Expression> Parser::parsePrimaryExpr() {
     AstPtr<Expression> Expr = nullptr;
     switch (CurTok.getKind()) {
         case TokenKind::Integer:
-            Expr = std::make_unique<LiteralExpr>(IntLiteral{ std::stoull(std::string(CurTok.getValue())) }, CurTok.getRange());
+            Expr = create<LiteralExpr>(IntLiteral{ std::stoull(std::string(CurTok.getValue())) }, CurTok.getRange());
             advanceToken();
             break;
         case TokenKind::True:
-            Expr = std::make_unique<LiteralExpr>(BoolLiteral{ true }, CurTok.getRange());
+            Expr = create<LiteralExpr>(BoolLiteral{ true }, CurTok.getRange());
             advanceToken();
             break;
         case TokenKind::False:
-            Expr = std::make_unique<LiteralExpr>(BoolLiteral{ false }, CurTok.getRange());
+            Expr = create<LiteralExpr>(BoolLiteral{ false }, CurTok.getRange());
             advanceToken();
             break;
         case TokenKind::Identifier:
-            Expr = std::make_unique<NamedExpr>(IdentifierSymbol{ std::string(CurTok.getValue()), CurTok.getRange() });
+            Expr = create<NamedExpr>(IdentifierSymbol{ TyContext->getIdentifiers().get(CurTok.getValue()), CurTok.getRange() });
             advanceToken();
             break;
         case TokenKind::LeftParen:
@@ -332,7 +511,13 @@ AstPtr<Expression> Parser::parsePrimaryExpr() {
         case TokenKind::LeftBrace:
             Expr = parseCompoundExpr();
             break;
-        
+        default:
+            // Skip the stray token so a statement loop cannot stall on it; a terminator is left to the caller.
+            Reporter.error(Source, CurTok.getRange(), std::format("expected expression, found '{}'", kindToString(CurTok.getKind())));
+            if (!CurTok.is(TokenKind::Semicolon, TokenKind::RightBrace, TokenKind::Eof)) {
+                advanceToken();
+            }
+            break;
     }
     return Expr;
 }
@@ -346,7 +531,7 @@ AstPtr<Expression> Parser::parseCompoundExpr() {
         Exprs.push_back(parseExpr());
     }
     const auto RightBrcTok = expectToken(TokenKind::RightBrace);
-    return std::make_unique<CompoundExpr>(std::move(Exprs), LeftBrcTok.getStart(), RightBrcTok.getEnd());
+    return create<CompoundExpr>(NodeArena->copyList(Exprs), LeftBrcTok.getStart(), RightBrcTok.getEnd());
 }
 
 TypeInfo Parser::parseTypeAnnotation() {
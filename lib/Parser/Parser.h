@@ -1,13 +1,16 @@
 #pragma once
 #include "Utils/SourceFile.h"
 #include "Lexer.h"
+#include "TokenBuffer.h"
 #include "AST/ASTBase.h"
 #include "AST/Type.h"
 #include "AST/TypeContext.h"
 #include "AST/Identifier.h"
+#include "Utils/Arena.h"
 #include <optional>
 #include <memory>
 #include <vector>
+#include <cstdint>
 
 class ErrorReporter;
 class Declaration;
@@ -15,12 +18,48 @@ class Statement;
 class Expression;
 class Module;
 
+class FunctionDecl;
+
+struct ParseOptions {
+    // Lex the whole file into a TokenBuffer before parsing.
+    bool PreLex = false;
+    // Other than 1 (0 means one per hardware thread), the file is lexed up front and its top-level declarations
+    // are parsed concurrently. The Module is the same as a serial parse gives; a file that does not split
+    // cleanly, or has a declaration with errors, is parsed serially instead. The names, NameIDs and types the
+    // workers created before such a fallback stay in the TypeContext unused, so getNumNames() and tables indexed
+    // by NameID grow by up to one more parse of the file.
+    unsigned Threads = 1;
+    // Skip function bodies, keeping only their signatures and where the bodies start. Parser::parseFunctionBody
+    // parses one on demand (see Seman::visitReachable).
+    bool LazyBodies = false;
+};
+
 class Parser {
 public:
-    static AstPtr<Module> parseSourceFile(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext = std::make_shared<TypeContext>());
-    explicit Parser(SourceFile& Source, ErrorReporter& Reporter);
-    AstPtr<Module> parseModule(std::shared_ptr<TypeContext> TypeContext);
+    static std::unique_ptr<Module> parseSourceFile(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext = std::make_shared<TypeContext>(), const ParseOptions& Options = {});
+    // Parses the body a lazy parse skipped. Nodes go into the first arena of Module.
+    static void parseFunctionBody(Module& Module, FunctionDecl& Function, ErrorReporter& Reporter);
+    // The token ranges of the top-level declarations, found by brace matching: a declaration ends at the brace
+    // closing its first one. Returns nullopt for anything but a sequence of `fn` and `struct` declarations.
+    static std::optional<std::vector<TokenRange>> findTopLevelDecls(const TokenBuffer& Tokens);
+    // Parse one declaration from Range, or the body of the function declared there, into NodeArena (see
+    // IncrementalCompiler). Return nullptr if it reports an error or does not end exactly at the end of Range.
+    static AstPtr<Declaration> parseDeclaration(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, TokenRange Range,
+                                                std::shared_ptr<TypeContext> TyContext, Arena& NodeArena);
+    static AstPtr<Statement> parseFunctionBody(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, TokenRange Range,
+                                               std::shared_ptr<TypeContext> TyContext, Arena& NodeArena);
+    explicit Parser(SourceFile& Source, ErrorReporter& Reporter, const ParseOptions& Options = {});
+    std::unique_ptr<Module> parseModule(std::shared_ptr<TypeContext> TypeContext);
 private:
+    Parser(SourceFile& Source, ErrorReporter& Reporter, const TokenBuffer& Tokens, std::shared_ptr<TypeContext> TyContext, bool LazyBodies);
+    Parser(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext, Arena& NodeArena, SourceLoc Start);
+    static std::unique_ptr<Module> parseModuleParallel(SourceFile& Source, ErrorReporter& Reporter, std::shared_ptr<TypeContext> TyContext, const ParseOptions& Options);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... Arguments) {
+        return NodeArena->create<T>(std::forward<Args>(Arguments)...);
+    }
+
     template <typename... T>
     std::optional<Token> consumeToken(T... Args);
     Token expectToken(TokenKind Kind);
@@ -28,8 +67,13 @@ private:
 
     IdentifierSymbol expectIdentifier();
     Token advanceToken();
+    Token lexToken();
 
+    AstPtr<Declaration> parseTopLevelDecl();
+    template <typename T>
+    AstPtr<T> parseInRange(TokenRange Range, AstPtr<T> (Parser::*Parse)());
     AstPtr<Declaration> parseFunctionDecl();
+    bool skipBody();
     AstPtr<Declaration> parseStructDecl();
 
     AstPtr<Statement> parseStmt();
@@ -43,7 +87,7 @@ private:
 
     AstPtr<Expression> parseExpr();
 
-    AstPtr<Expression> parseBinaryExpr(int Prec = 0);
+    AstPtr<Expression> parseBinaryExpr(std::uint8_t MinPower = 0);
     AstPtr<Expression> parseCastExpr();
     AstPtr<Expression> parseUnaryExpr();
     AstPtr<Expression> parsePostFixExpr();
@@ -58,7 +102,16 @@ private:
 
     ErrorReporter& Reporter;
     std::shared_ptr<TypeContext> TyContext;
+    // The arena parseModule hands over to the Module; NodeArena points to it unless parsing a single body.
+    std::unique_ptr<Arena> OwnedArena = std::make_unique<Arena>();
+    Arena* NodeArena = OwnedArena.get();
     SourceFile &Source;
     Lexer Lex;
+    std::optional<TokenBuffer> OwnedTokens;
+    const TokenBuffer* Tokens;
+    std::size_t NextTokIndex = 0;
+    // Tokens from this index on read as Eof.
+    std::size_t EndTokIndex = SIZE_MAX;
+    bool LazyBodies = false;
     Token CurTok;
 };
@@ -0,0 +1,32 @@
+#include "TokenBuffer.h"
+#include "Lexer.h"
+#include "Utils/TimeReport.h"
+#include <algorithm>
+
+TokenBuffer::TokenBuffer(std::string_view Source, std::size_t Begin, std::size_t End) : Source(Source) {
+    TraceScope Span("lex");
+    Lexer Lex(Source.substr(0, End), Begin);
+    while (true) {
+        const auto Tok = Lex.nextToken();
+        Kinds.push_back(static_cast<std::int8_t>(Tok.getKind()));
+        Offsets.push_back(Tok.getStart().Offset);
+        Lengths.push_back(static_cast<std::uint32_t>(Tok.getValue().size()));
+        if (Tok.is(TokenKind::Eof)) {
+            break;
+        }
+    }
+}
+
+TokenKind TokenBuffer::getKind(std::size_t Index) const {
+    return static_cast<TokenKind>(Kinds[clamp(Index)]);
+}
+
+Token TokenBuffer::getToken(std::size_t Index) const {
+    Index = clamp(Index);
+    return { getKind(Index), { Offsets[Index] }, Source.substr(Offsets[Index], Lengths[Index]) };
+}
+
+std::size_t TokenBuffer::clamp(std::size_t Index) const {
+    // Everything past the end reads as the trailing Eof token.
+    return std::min(Index, Kinds.size() - 1);
+}
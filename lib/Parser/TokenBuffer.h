@@ -0,0 +1,25 @@
+#pragma once
+#include "Token.h"
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Tokens [first, second) of a TokenBuffer.
+using TokenRange = std::pair<std::size_t, std::size_t>;
+
+// Whole-file token stream stored as parallel arrays, so the parser can
+// walk (and look ahead in) it by index.
+class TokenBuffer {
+public:
+    // Lexes Source[Begin, End); offsets stay relative to the start of Source.
+    explicit TokenBuffer(std::string_view Source, std::size_t Begin = 0, std::size_t End = std::string_view::npos);
+    [[nodiscard]] std::size_t size() const { return Kinds.size(); }
+    [[nodiscard]] TokenKind getKind(std::size_t Index) const;
+    [[nodiscard]] Token getToken(std::size_t Index) const;
+private:
+    [[nodiscard]] std::size_t clamp(std::size_t Index) const;
+    std::string_view Source;
+    std::vector<std::int8_t> Kinds;
+    std::vector<std::uint32_t> Offsets, Lengths;
+};
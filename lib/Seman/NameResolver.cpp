@@ -2,14 +2,15 @@
 #include "Seman.h"
 #include "TypeResolver.h"
 #include <format>
-#include <map>
 
-NameResolver::NameResolver(Seman& SemanInfo, const std::vector<const StructType*>& StructTypes) : SemanInfo(SemanInfo) {
+NameResolver::NameResolver(Seman& SemanInfo, const std::vector<const StructType*>& StructTypes,
+                           const std::unordered_set<const FunctionDecl*>* Bodies) : SemanInfo(SemanInfo), Bodies(Bodies) {
+    auto& Identifiers = SemanInfo.getTyContext().getIdentifiers();
     for (const auto Ty : SemanInfo.getTyContext().getBuiltinTypes()) {
-        Types[Ty->toString()] = Ty;
+        Types[Identifiers.get(Ty->toString())->getID()] = Ty;
     }
     for (const auto Ty : StructTypes) {
-        Types[Ty->toString()] = Ty;
+        Types[Ty->getDecl().getIdentifier().getID()] = Ty;
     }
 }
 
@@ -19,9 +20,10 @@ void NameResolver::visit(Module& Module) {
 }
 
 void NameResolver::visit(FunctionDecl& FunctionDecl) { //TODO take all function first in an initial pass
-    const auto& Name = FunctionDecl.getIdentifier().getName();
-    if (!CurrentScope->find(Name)) {
-        CurrentScope->insert(Name, &FunctionDecl);
+    const auto Name = FunctionDecl.getIdentifier().getID();
+    if (!CurrentScope.find(Name)) {
+        CurrentScope.insert(Name, &FunctionDecl);
+        Functions.emplace(Name, &FunctionDecl);
     } else {
         // TODO redefinition error
     }
@@ -30,7 +32,7 @@ void NameResolver::visit(FunctionDecl& FunctionDecl) { //TODO take all function
     std::vector<const Type*> ParamTypes;
 
     for (const auto& Param : FunctionDecl.getParams()) {
-        CurrentScope->insert(Param.getName(), &Param);
+        CurrentScope.insert(Param.getIdentifier().getID(), &Param);
         if (Param.ParamType == nullptr) {
             const auto Msg = "function parameter requires explicit type annotation";
             SemanInfo.error(Param.getIdentifier().getRange(), Msg);
@@ -53,17 +55,30 @@ void NameResolver::visit(FunctionDecl& FunctionDecl) { //TODO take all function
         SemanInfo.setType(FunctionDecl, FunctionTy);
     }
 
-    FunctionDecl.getBody().accept(*this);
+    if (FunctionDecl.isBodyParsed() && (Bodies == nullptr || Bodies->contains(&FunctionDecl))) {
+        FunctionDecl.getBody().accept(*this);
+    }
+}
+
+void NameResolver::resolveBody(FunctionDecl& FunctionDecl) {
+    BodyFunction = &FunctionDecl;
+    {
+        ScopeGuard Guard(CurrentScope);
+        for (const auto& Param : FunctionDecl.getParams()) {
+            CurrentScope.insert(Param.getIdentifier().getID(), &Param);
+        }
+        FunctionDecl.getBody().accept(*this);
+    }
+    BodyFunction = nullptr;
 }
 
 void NameResolver::visit(LetStmt& Node) {
     auto& Identifier = Node.getIdentifier();
-    auto& Name = Identifier.getName();
-    if (CurrentScope->find(Name)) {
-        const auto Msg = std::format("'{}' is already defined", Name);
+    if (lookup(Identifier.getID())) {
+        const auto Msg = std::format("'{}' is already defined", Identifier.getName());
         SemanInfo.error(Identifier.getRange(), Msg);
     }
-    CurrentScope->insert(Name, &Node);
+    CurrentScope.insert(Identifier.getID(), &Node);
 
     if (const auto ResolvedType = tryResolveType(*Node.getTypeInfo().getType())) {
         SemanInfo.setType(Node, ResolvedType);
@@ -78,16 +93,32 @@ void NameResolver::visit(CompoundStmt& CompoundStmt) {
 }
 
 void NameResolver::visit(NamedExpr& NamedExpr) {
-    const auto& Name = NamedExpr.getIdentifier().getName();
-    const auto Sym = CurrentScope->find(Name);
+    const auto& Identifier = NamedExpr.getIdentifier();
+    const auto Sym = lookup(Identifier.getID());
+    // Cleared on failure too, since an incremental rebuild may resolve the same node again.
+    NamedExpr.setRefedName(Sym);
     if (Sym == nullptr) {
-        const auto Msg = std::format("Symbol '{}' not found", Name);
+        const auto Msg = std::format("Symbol '{}' not found", Identifier.getName());
         SemanInfo.error(NamedExpr.getIdentifier().getRange(), Msg);
-    } else {
-        NamedExpr.setRefedName(*Sym);
     }
 }
 
+const Nameable* NameResolver::lookup(std::uint32_t Name) {
+    if (const auto Sym = CurrentScope.find(Name)) {
+        return *Sym;
+    }
+    if (BodyFunction == nullptr) {
+        return nullptr;
+    }
+    // In place, the body would have seen the functions declared up to its own.
+    const auto Iter = Functions.find(Name);
+    if (Iter == Functions.end() ||
+        Iter->second->getIdentifier().getRange().Start.Offset > BodyFunction->getIdentifier().getRange().Start.Offset) {
+        return nullptr;
+    }
+    return Iter->second;
+}
+
 void NameResolver::visit(CastExpr& CastExpr) {
     const auto& CastTypeInfo = CastExpr.getTypeInfo();
     const auto CastType = CastTypeInfo.getType();
@@ -112,8 +143,10 @@ const Type* NameResolver::tryResolveType(const Type& Ty) {
     const auto [ResolvedType, FailedResolve] = TyResolver.resolve(Ty);
 
     if (FailedResolve) {
-        const auto Msg = std::format("type '{}' not found", FailedResolve->toString());
-        SemanInfo.error(FailedResolve->getIdentifier().getRange(), Msg);
+        if (ReportedTypes.insert(FailedResolve).second) {
+            const auto Msg = std::format("type '{}' not found", FailedResolve->toString());
+            SemanInfo.error(FailedResolve->getIdentifier().getRange(), Msg);
+        }
         return nullptr;
     }
 
@@ -1,13 +1,17 @@
 #pragma once
 #include "AST/ASTVisitor.h"
 #include "Scope.h"
-#include <map>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 
 class Seman;
 
 class NameResolver : public AstVisitor {
 public:
-    NameResolver(Seman& SemanInfo, const std::vector<const StructType*> &StructTypes);
+    // With Bodies set, only the bodies of those functions are resolved.
+    NameResolver(Seman& SemanInfo, const std::vector<const StructType*> &StructTypes,
+                 const std::unordered_set<const FunctionDecl*>* Bodies = nullptr);
     void visit(Module&) override;
     void visit(FunctionDecl&) override;
     void visit(LetStmt&) override;
@@ -15,9 +19,18 @@ public:
     void visit(NamedExpr&) override;
     void visit(CastExpr&) override;
     void visit(StructDecl&) override;
+    // Resolves a body parsed after the module was visited, as if it had been resolved in place.
+    void resolveBody(FunctionDecl&);
 private:
+    const Nameable* lookup(std::uint32_t Name);
     const Type* tryResolveType(const Type& Ty);
     Seman& SemanInfo;
-    std::map<std::string, const Type*> Types;
-    std::unique_ptr<Scope<const Nameable*>> CurrentScope = nullptr;
+    const std::unordered_set<const FunctionDecl*>* Bodies;
+    std::unordered_map<std::uint32_t, const Type*> Types;
+    // Unresolved types are unique per name, so each unknown name is reported once.
+    std::unordered_set<const UnresolvedType*> ReportedTypes;
+    Scope<const Nameable*> CurrentScope;
+    // The first function declared with each name; resolveBody looks callees up here instead of in module scope.
+    std::unordered_map<std::uint32_t, const FunctionDecl*> Functions;
+    const FunctionDecl* BodyFunction = nullptr;
 }; 
\ No newline at end of file
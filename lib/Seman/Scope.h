@@ -1,45 +1,69 @@
 #pragma once
-#include <string>
 #include <cassert>
-#include <memory>
-#include <map>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
+// All scopes share one flat binding stack. Current maps a name ID to its
+// innermost binding; a binding remembers the one it shadows so leaving a
+// scope restores it. Entering and leaving allocates nothing once the
+// vectors have grown.
 template <typename Value>
 class Scope {
 public:
-    Scope(Scope* Parent) : Parent(Parent) {
-        
+    void enter() {
+        Marks.push_back(Bindings.size());
     }
-    void insert(const std::string& Name, Value Val) {
-        assert(!Values.contains(Name));
-        Values[Name] = Val;
+    void leave() {
+        assert(!Marks.empty());
+        while (Bindings.size() > Marks.back()) {
+            const auto& Last = Bindings.back();
+            Current[Last.Name] = Last.Shadowed;
+            Bindings.pop_back();
+        }
+        Marks.pop_back();
+    }
+    void insert(std::uint32_t Name, Value Val) {
+        if (Name >= Current.size()) {
+            Current.resize(Name + 1, NoBinding);
+        }
+        const auto Shadowed = Current[Name];
+        assert(Shadowed == NoBinding || Bindings[Shadowed].Depth != Marks.size());
+        Current[Name] = static_cast<std::uint32_t>(Bindings.size());
+        Bindings.push_back({ Name, Shadowed, Marks.size(), Val });
     }
-    Value* find(const std::string& Name) {
-        const auto Iter = Values.find(Name);
-        if (Iter != Values.end()) {
-            return &Iter->second;
+    Value* find(std::uint32_t Name) {
+        if (Name >= Current.size() || Current[Name] == NoBinding) {
+            return nullptr;
         }
-        return Parent == nullptr ? nullptr : Parent->find(Name);
+        return &Bindings[Current[Name]].Val;
     }
 private:
-    std::map<std::string, Value> Values;
-    Scope* Parent;
+    static constexpr auto NoBinding = std::numeric_limits<std::uint32_t>::max();
+    struct Binding {
+        std::uint32_t Name;
+        std::uint32_t Shadowed;
+        size_t Depth;
+        Value Val;
+    };
+    std::vector<Binding> Bindings;
+    std::vector<size_t> Marks;
+    std::vector<std::uint32_t> Current;
 };
 
 template <typename Value>
 class ScopeGuard {
 public:
-    explicit ScopeGuard(std::unique_ptr<Scope<Value>>& CurrentScope) : CurrentScope(CurrentScope), Previous(std::move(CurrentScope)) {
-        CurrentScope = std::make_unique<Scope<Value>>(Previous.get());
+    explicit ScopeGuard(Scope<Value>& CurrentScope) : CurrentScope(CurrentScope) {
+        CurrentScope.enter();
     }
     ScopeGuard(ScopeGuard&) = delete;
     auto& operator=(ScopeGuard&) = delete;
     ScopeGuard(ScopeGuard&&) = delete;
     auto& operator=(ScopeGuard&&) = delete;
     ~ScopeGuard() {
-        CurrentScope = std::move(Previous);
+        CurrentScope.leave();
     }
 private:
-    std::unique_ptr<Scope<Value>>& CurrentScope;
-    std::unique_ptr<Scope<Value>> Previous;
+    Scope<Value>& CurrentScope;
 };
\ No newline at end of file
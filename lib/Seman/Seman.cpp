@@ -2,20 +2,124 @@
 #include "Validator.h"
 #include "NameResolver.h"
 #include "TypeCheck.h"
+#include "AST/Module.h"
+#include "Parser/Parser.h"
+#include "Utils/TimeReport.h"
+#include <algorithm>
+#include <unordered_set>
 
+namespace {
+    // Collects the names referenced in a body.
+    class ReferenceCollector : public AstConstVisitor {
+    public:
+        void visit(const NamedExpr& Node) override {
+            if (Node.getRefedName() != nullptr) {
+                References.push_back(Node.getRefedName());
+            }
+        }
+        std::vector<const Nameable*> References;
+    };
+}
 
 Seman::Seman(TypeContext& TyContext, ErrorReporter& Reporter) : TyContext(TyContext), Reporter(Reporter) {
 }
 
+Seman::~Seman() = default;
+
 void Seman::visit(Module& Module) {
+    analyze(Module, nullptr);
+}
+
+void Seman::visitChanged(Module& Module, const std::unordered_set<const FunctionDecl*>& Changed) {
+    analyze(Module, &Changed);
+}
+
+void Seman::analyze(Module& Module, const std::unordered_set<const FunctionDecl*>* Changed) {
     CurrentSource = &Module.getSourceFile();
+    NamesResolvedTypes.reserve(TyContext.getNumNames());
+    Resolver = nullptr;
     Validator Validator(*this, TyContext);
-    if (Validator.doVisit(Module)) {
-        return;
+    {
+        TimeScope Scope("validate");
+        if (Validator.doVisit(Module)) {
+            return;
+        }
     }
     const auto& StructTypes = Validator.getStructTypes();
-    NameResolver Resolver(*this, StructTypes);
-    Module.accept(Resolver);
+    {
+        TimeScope Scope("resolve names");
+        Resolver = std::make_unique<NameResolver>(*this, StructTypes, Changed);
+        Module.accept(*Resolver);
+    }
+    TimeScope Scope("type check");
     TypeCheck TyCheck(*this);
-    TyCheck.doVisit(Module);
+    if (Changed == nullptr) {
+        TyCheck.doVisit(Module);
+        return;
+    }
+    for (const auto Decl : Module.getDeclarations()) {
+        const auto Function = dynamic_cast<const FunctionDecl*>(Decl);
+        if (Function == nullptr || Changed->contains(Function)) {
+            TyCheck.doVisit(*Decl);
+        }
+    }
+}
+
+std::vector<const FunctionDecl*> Seman::visitReachable(Module& Module, std::span<const std::string> Roots) {
+    TimeScope Scope("check reachable");
+    if (Resolver == nullptr && Module.BodySource == nullptr) {
+        return {};
+    }
+    DenseTable<FunctionDecl*> Functions;
+    std::vector<FunctionDecl*> Worklist;
+    for (const auto Decl : Module.getDeclarations()) {
+        if (const auto Function = dynamic_cast<FunctionDecl*>(Decl)) {
+            Functions[Function->getNameID()] = Function;
+            if (std::ranges::find(Roots, Function->getName()) != Roots.end()) {
+                Worklist.push_back(Function);
+            }
+        }
+    }
+
+    std::unordered_set<const FunctionDecl*> Reached;
+    while (!Worklist.empty()) {
+        auto& Function = *Worklist.back();
+        Worklist.pop_back();
+        if (!Reached.insert(&Function).second) {
+            continue;
+        }
+        if (!Function.isBodyParsed() && Module.BodySource != nullptr) {
+            // A body that cannot be read is reported and leaves the function a declaration.
+            if (!Module.BodySource->loadBody(Function)) {
+                Reporter.error(Module.getSourceFile(), Module.BodySource->getError());
+                continue;
+            }
+        } else if (!Function.isBodyParsed()) {
+            // A body with syntax errors may hold null nodes, so it is dropped unchecked like one that cannot be read.
+            const auto NumErrors = Reporter.getNumErrors();
+            Parser::parseFunctionBody(Module, Function, Reporter);
+            if (Reporter.getNumErrors() != NumErrors) {
+                Function.setBody(nullptr);
+                continue;
+            }
+            Resolver->resolveBody(Function);
+            TypeCheck TyCheck(*this);
+            TyCheck.doVisit(Function);
+        }
+        ReferenceCollector Collector;
+        Function.getBody().accept(Collector);
+        for (const auto Ref : Collector.References) {
+            if (const auto Callee = Functions.lookup(Ref->getNameID())) {
+                Worklist.push_back(Callee);
+            }
+        }
+    }
+
+    std::vector<const FunctionDecl*> Result;
+    for (const auto Decl : Module.getDeclarations()) {
+        if (const auto Function = dynamic_cast<const FunctionDecl*>(Decl); Function && Reached.contains(Function)) {
+            Result.push_back(Function);
+        }
+    }
+    return Result;
 }
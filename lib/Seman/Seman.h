@@ -1,14 +1,32 @@
 #pragma once
 #include "AST/ASTVisitor.h"
+#include "Utils/DenseTable.h"
 #include "Utils/ErrorReporter.h"
-#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class NameResolver;
 
 // TODO
 // cyclic structs
 class Seman : public AstVisitor {
 public:
     Seman(TypeContext& TyContext, ErrorReporter& Reporter);
+    ~Seman() override;
+    // Bodies a lazy parse skipped are left unchecked.
     void visit(Module&) override;
+    // After visit, parses and checks the skipped bodies reachable by calls from the functions named in Roots.
+    // Returns every reached function in declaration order, ready for CodeGen::doIt; the rest never get a body.
+    // A module with a BodySource needs no visit first; its bodies are loaded from there already checked. A body
+    // that cannot be loaded or parsed is reported, and its function is returned without a body.
+    std::vector<const FunctionDecl*> visitReachable(Module& Module, std::span<const std::string> Roots);
+    // Re-analyzes a module rebuilt from the declarations of the one this Seman last visited (see
+    // IncrementalCompiler). Signatures are checked again, but only the bodies of Changed are; every other
+    // function keeps its previous results, and every struct declaration seen before keeps its type.
+    void visitChanged(Module& Module, const std::unordered_set<const FunctionDecl*>& Changed);
 
     TypeContext& getTyContext() const { return TyContext; }
 
@@ -17,20 +35,19 @@ public:
     }
 
     const Type* getType(const Nameable& Name) const {
-        const auto Iter = NamesResolvedTypes.find(&Name);
-        if (Iter == NamesResolvedTypes.end()) {
-            return nullptr;
-        }
-        return Iter->second;
+        return NamesResolvedTypes.lookup(Name.getNameID());
     }
 
     void setType(const Nameable& Name, const Type* Type) {
-        NamesResolvedTypes[&Name] = Type;
+        NamesResolvedTypes[Name.getNameID()] = Type;
     }
 
 private:
-    std::map<const IdentifierSymbol*, const Nameable*> ReferencedNames;
-    std::map<const Nameable*, const Type*> NamesResolvedTypes;
+    void analyze(Module& Module, const std::unordered_set<const FunctionDecl*>* Changed);
+
+    DenseTable<const Type*> NamesResolvedTypes;
+    // Kept from visit for visitReachable; null if the module failed validation.
+    std::unique_ptr<NameResolver> Resolver;
     SourceFile* CurrentSource = nullptr;
     TypeContext& TyContext;
     ErrorReporter& Reporter;
@@ -59,6 +59,10 @@ void TypeCheck::visit(BinaryOpExpr& BinaryOpExpr) {
 }
 
 void TypeCheck::visit(NamedExpr& NamedExpr) {
+    // NameResolver has reported the unknown name.
+    if (NamedExpr.getRefedName() == nullptr) {
+        return typecheckFail();
+    }
     const auto& NameRef = *NamedExpr.getRefedName();
     auto Ty = SemanInfo.getType(NameRef);
 
@@ -114,6 +118,10 @@ void TypeCheck::visit(FunctionDecl& FunctionDecl) {
 void TypeCheck::visit(LetStmt& LetStmt) {
     const auto Value = LetStmt.getValue();
     const auto LetTy = SemanInfo.getType(LetStmt);
+    // NameResolver has reported the unknown type.
+    if (LetTy == nullptr) {
+        return typecheckFail();
+    }
     if (Value) {
         const auto Res = check(*Value);
         if (Res.isInvalid()) {
@@ -287,7 +295,7 @@ void TypeCheck::visit(DotExpr& DotExpr) {
 
     if (LeftRes.getType()->isStructType()) {
         const auto& StructTy = LeftRes.getType()->as<StructType>();
-        const auto [Field, FieldTy] = getStructField(StructTy, Identifier.getName());
+        const auto [Field, FieldTy] = getStructField(StructTy, Identifier.getInfo());
 
         if (!Field) {
             const auto Msg = std::format("type '{}' has no field named '{}'", StructTy.toString(), Identifier.getName());
@@ -371,7 +379,7 @@ void TypeCheck::validateCallArgs(const FunctionType& FunctionTy, const FunctionC
 }
 
 std::pair<const StructDeclField*, const Type*> TypeCheck::getStructField(
-    const StructType& StructTy, const std::string& FieldName) const {
+    const StructType& StructTy, const IdentifierInfo* FieldName) const {
     const auto Field = StructTy.getField(FieldName);
     if (!Field) {
         return { nullptr, nullptr };
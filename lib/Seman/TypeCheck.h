@@ -49,7 +49,7 @@ private:
 
     void validateCallArgs(const FunctionType& FunctionTy, const FunctionCallExpr& FunctionCallExpr);
     std::pair<const StructDeclField*, const Type*> getStructField(const StructType& StructTy,
-                                                                  const std::string& FieldName) const;
+                                                                  const IdentifierInfo* FieldName) const;
     static bool checkCast(const Type* From, const Type* To);
     ExprResult checkDereferenceOp(ExprResult Res, const SourceRange& Range) const;
     ExprResult checkAddressofOp(ExprResult Res, const SourceRange& Range) const;
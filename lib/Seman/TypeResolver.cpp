@@ -1,7 +1,7 @@
 #include "TypeResolver.h"
 #include "AST/TypeContext.h"
 
-TypeResolver::TypeResolver(TypeContext& TyContext, std::map<std::string, const Type*>& ResolvedTypes) : TyContext(TyContext), ResolvedTypes(ResolvedTypes) {
+TypeResolver::TypeResolver(TypeContext& TyContext, std::unordered_map<std::uint32_t, const Type*>& ResolvedTypes) : TyContext(TyContext), ResolvedTypes(ResolvedTypes) {
 
 }
 
@@ -11,8 +11,7 @@ std::pair<const Type*, const UnresolvedType*> TypeResolver::resolve(const Type&
 }
 
 void TypeResolver::visit(const UnresolvedType& Ty) {
-    const auto TypeName = Ty.toString();
-    const auto Iter = ResolvedTypes.find(TypeName);
+    const auto Iter = ResolvedTypes.find(Ty.getIdentifier().getID());
     if (Iter == ResolvedTypes.end()) {
         FailedToResolve = &Ty;
     } else {
@@ -2,14 +2,15 @@
 #include "AST/TypeVisitor.h"
 #include "AST/Type.h"
 #include "Utils/VisitorBase.h"
-#include <map>
+#include <cstdint>
+#include <unordered_map>
 #include <utility>
 
 class TypeContext;
 
 class TypeResolver : public VisitorBase<TypeResolver, const Type, const Type*>, public TypeVisitor {
 public:
-    TypeResolver(TypeContext& TyContext, std::map<std::string, const Type*>& ResolvedTypes);
+    TypeResolver(TypeContext& TyContext, std::unordered_map<std::uint32_t, const Type*>& ResolvedTypes);
     void visit(const UnresolvedType& Ty) override;
     void visit(const PointerType& Ty) override;
     void visit(const ArrayType& Ty) override;
@@ -19,5 +20,5 @@ public:
 private:
     TypeContext& TyContext;
     const UnresolvedType *FailedToResolve = nullptr;
-    std::map<std::string, const Type*> &ResolvedTypes;
+    std::unordered_map<std::uint32_t, const Type*> &ResolvedTypes;
 };
\ No newline at end of file
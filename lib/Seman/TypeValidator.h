@@ -1,6 +1,7 @@
 #pragma once
 #include "AST/TypeVisitor.h"
-#include <map>
+#include "Utils/DenseTable.h"
+#include <cstdint>
 
 class Seman;
 
@@ -16,14 +17,15 @@ public:
         }
     }
 private:
+    enum class VisitState : std::uint8_t { Unvisited, Visiting, Visited };
     bool isVisiting(const Type& Type) const {
-        return IsVisited.contains(&Type) && !IsVisited.at(&Type);
+        return States.lookup(Type.getID()) == VisitState::Visiting;
     }
     bool isVisited(const Type& Type) const {
-        return IsVisited.contains(&Type) && IsVisited.at(&Type);
+        return States.lookup(Type.getID()) == VisitState::Visited;
     }
-    void setVisiting(const Type& Type) { IsVisited[&Type] = false; }
-    void setVisited(const Type& Type) { IsVisited[&Type] = true; }
-    std::map<const Type*, bool> IsVisited;
+    void setVisiting(const Type& Type) { States[Type.getID()] = VisitState::Visiting; }
+    void setVisited(const Type& Type) { States[Type.getID()] = VisitState::Visited; }
+    DenseTable<VisitState> States;
     Seman& SemanInfo;
 };
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include "AST/TypeContext.h"
 #include <ranges>
 #include <set>
-#include <string>
+#include <cstdint>
 #include <format>
 
 
@@ -11,11 +11,11 @@ Validator::Validator(Seman& SemanInfo, TypeContext& TyContext) : SemanInfo(Seman
 }
 
 void Validator::visit(const FunctionDecl& FunctionDecl) {
-    std::set<std::string> ParamNames;
+    std::set<std::uint32_t> ParamNames;
     for (auto& Param : FunctionDecl.getParams()) {
-        auto& ParamName = Param.getName();
+        const auto ParamName = Param.getIdentifier().getID();
         if (ParamNames.contains(ParamName)) {
-            const auto Msg = std::format("parameter name '{}' is already used", ParamName);
+            const auto Msg = std::format("parameter name '{}' is already used", Param.getName());
             SemanInfo.error(Param.getIdentifier().getRange(), Msg);
             return returnValue(true);
         }
@@ -24,11 +24,11 @@ void Validator::visit(const FunctionDecl& FunctionDecl) {
 }
 
 void Validator::visit(const StructDecl& StructDecl) {
-    std::set<std::string> FieldNames;
+    std::set<std::uint32_t> FieldNames;
     for (auto& Field : StructDecl.getFields()) {
-        auto& FieldName = Field.getName();
+        const auto FieldName = Field.getIdentifier().getID();
         if (FieldNames.contains(FieldName)) {
-            const auto Msg = std::format("field name '{}' is already used", FieldName);
+            const auto Msg = std::format("field name '{}' is already used", Field.getName());
             SemanInfo.error(Field.getIdentifier().getRange(), Msg);
             return returnValue(true);
         }
@@ -36,13 +36,18 @@ void Validator::visit(const StructDecl& StructDecl) {
     }
 
     const auto Iter = std::ranges::find_if(StructTypes, [&StructDecl](auto& StructTy) {
-        return StructDecl.getIdentifier().getName() == StructTy->getName();
+        return StructDecl.getIdentifier().getInfo() == StructTy->getDecl().getIdentifier().getInfo();
     });
 
     if (Iter != StructTypes.end()) {
         return;
     }
 
+    // A declaration kept from an earlier incremental build keeps its type, so types built from it stay valid.
+    if (const auto Existing = SemanInfo.getType(StructDecl)) {
+        StructTypes.push_back(&Existing->as<StructType>());
+        return;
+    }
     const auto Ty = TyContext.createStructType(StructDecl.getIdentifier().getName(), StructDecl);
     StructTypes.push_back(Ty);
     SemanInfo.setType(StructDecl, Ty);
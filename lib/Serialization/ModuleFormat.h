@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Layout of a precompiled module, the output of writeModule and the input of ModuleReader.
+//
+// A fixed header (magic, version, number of names, offset of the bodies section; little-endian 32-bit
+// integers) is followed by these sections, each a count and that many records:
+//   identifiers   the source path, then every spelling the module uses, referred to by index
+//   structs       struct declarations with their fields, whose types are only known after the type table
+//   types         the type table, every entry after the types it is built from
+//   declarations  in source order; a struct refers to its entry above, a function carries its signature and
+//                 the offset of its body in the bodies section
+//   bodies        one record per function body, decoded only when the body is needed
+// Everything else is an LEB128 varint. A type is written as its index in the table plus one, zero meaning
+// none, and a source location as the signed difference from the previous one in the same record.
+//
+// Declarations, parameters, fields and lets are numbered densely in the order they are written, structs
+// before functions, and a reader gives each a NameID from a block it reserves (see
+// TypeContext::allocateNameIDs). A body record starts with the number of its first let; a name a NamedExpr
+// refers to is written as its number plus one. Seman's results are stored with the nodes they belong to: the
+// resolved type of every name and the type of every expression.
+struct ModuleFormat {
+    static constexpr std::string_view Magic = "UNLM";
+    // Bump on any change to the layout.
+    static constexpr std::uint32_t Version = 1;
+    static constexpr std::size_t HeaderSize = 16;
+
+    enum class TypeKind : std::uint8_t {
+        Builtin,
+        Pointer,
+        Array,
+        Function,
+        Struct,
+        Unresolved
+    };
+
+    enum class DeclKind : std::uint8_t {
+        Function,
+        Struct
+    };
+
+    // None stands for an absent optional child, such as an else branch.
+    enum class NodeKind : std::uint8_t {
+        None,
+        Literal,
+        BinaryOp,
+        UnaryOp,
+        FunctionCall,
+        Named,
+        Dot,
+        Cast,
+        Subscript,
+        CompoundExpr,
+        If,
+        Let,
+        While,
+        ExpressionStmt,
+        CompoundStmt,
+        Return,
+        Assign
+    };
+
+    enum class LiteralKind : std::uint8_t {
+        Int,
+        Float,
+        Bool,
+        String
+    };
+};
\ No newline at end of file
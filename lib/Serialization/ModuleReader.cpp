@@ -0,0 +1,525 @@
+#include "ModuleReader.h"
+#include "ModuleFormat.h"
+#include "Seman/Seman.h"
+#include "Utils/TimeReport.h"
+#include <bit>
+#include <cassert>
+#include <format>
+#include <utility>
+
+// Decodes one section or record. Running past its end or finding anything the writer cannot have produced
+// marks it failed; reads after that return zero, so callers check failed once they are done.
+class ModuleReader::Cursor {
+public:
+    explicit Cursor(std::string_view Bytes) : Pos(Bytes.data()), End(Bytes.data() + Bytes.size()) {
+    }
+
+    bool failed() const { return Failed; }
+    bool atEnd() const { return Pos == End; }
+
+    void fail() {
+        Failed = true;
+        Pos = End;
+    }
+
+    std::uint8_t readByte() {
+        if (Pos == End) {
+            fail();
+            return 0;
+        }
+        return static_cast<std::uint8_t>(*Pos++);
+    }
+
+    std::uint64_t readVarint() {
+        std::uint64_t Value = 0;
+        for (unsigned Shift = 0; Shift < 64; Shift += 7) {
+            const auto Byte = readByte();
+            Value |= static_cast<std::uint64_t>(Byte & 0x7F) << Shift;
+            if ((Byte & 0x80) == 0) {
+                return Value;
+            }
+        }
+        fail();
+        return 0;
+    }
+
+    std::uint64_t readFixed(unsigned Size) {
+        std::uint64_t Value = 0;
+        for (unsigned Index = 0; Index < Size; Index++) {
+            Value |= static_cast<std::uint64_t>(readByte()) << (Index * 8);
+        }
+        return Value;
+    }
+
+    std::string_view readString() {
+        const auto Size = readVarint();
+        if (Size > static_cast<std::uint64_t>(End - Pos)) {
+            fail();
+            return {};
+        }
+        const std::string_view Str(Pos, Size);
+        Pos += Size;
+        return Str;
+    }
+
+    SourceLoc readLoc() {
+        const auto Encoded = readVarint();
+        LastOffset += static_cast<std::int64_t>(Encoded >> 1) ^ -static_cast<std::int64_t>(Encoded & 1);
+        return { static_cast<std::uint32_t>(LastOffset) };
+    }
+
+    SourceRange readRange() {
+        const auto Start = readLoc();
+        return { Start, readLoc() };
+    }
+
+    void startRecord() { LastOffset = 0; }
+
+    // The number the next name declared in the record gets.
+    std::uint32_t NextName = 0;
+    // Each NamedExpr read with the number of the name it refers to, plus one. A let is in scope in its own
+    // value, so the references are only filled in once the whole record is read.
+    std::vector<std::pair<NamedExpr*, std::uint64_t>> Refs;
+
+private:
+    const char* Pos;
+    const char* End;
+    bool Failed = false;
+    std::int64_t LastOffset = 0;
+};
+
+std::unique_ptr<ModuleReader> ModuleReader::open(const std::string& Path, std::string& Error) {
+    auto Buffer = SourceBuffer::fromFile(Path);
+    const auto Data = Buffer->getContents();
+    if (Data.size() < ModuleFormat::HeaderSize || !Data.starts_with(ModuleFormat::Magic)) {
+        Error = std::format("'{}' is not a module file", Path);
+        return nullptr;
+    }
+    Cursor Header(Data.substr(ModuleFormat::Magic.size(), ModuleFormat::HeaderSize - ModuleFormat::Magic.size()));
+    const auto Version = Header.readFixed(4);
+    const auto NumNames = static_cast<std::uint32_t>(Header.readFixed(4));
+    const auto BodiesOffset = static_cast<std::uint32_t>(Header.readFixed(4));
+    if (Version != ModuleFormat::Version) {
+        Error = std::format("'{}' has module format version {}, expected {}", Path, Version, ModuleFormat::Version);
+        return nullptr;
+    }
+    // Every name takes at least a byte, which bounds what read reserves for a corrupt count.
+    if (BodiesOffset < ModuleFormat::HeaderSize || BodiesOffset > Data.size() || NumNames > Data.size()) {
+        Error = std::format("'{}' is truncated or corrupt", Path);
+        return nullptr;
+    }
+    return std::unique_ptr<ModuleReader>(new ModuleReader(std::move(Buffer), NumNames, BodiesOffset));
+}
+
+ModuleReader::ModuleReader(std::unique_ptr<SourceBuffer> Buffer, std::uint32_t NumNames, std::uint32_t BodiesOffset) :
+    Buffer(std::move(Buffer)), Data(this->Buffer->getContents()), NumNames(NumNames), BodiesOffset(BodiesOffset) {
+}
+
+ModuleReader::~ModuleReader() = default;
+
+std::unique_ptr<Module> ModuleReader::read(std::shared_ptr<TypeContext> Context, Seman& Info, bool Lazy) {
+    assert(SemanInfo == nullptr && &Info.getTyContext() == Context.get());
+    TimeScope Scope("read module");
+    TyContext = std::move(Context);
+    SemanInfo = &Info;
+    auto OwnedArena = std::make_unique<Arena>();
+    NodeArena = OwnedArena.get();
+    FirstNameID = TyContext->allocateNameIDs(NumNames);
+    Names.assign(NumNames, nullptr);
+
+    Cursor In(Data.substr(ModuleFormat::HeaderSize, BodiesOffset - ModuleFormat::HeaderSize));
+    Source = std::make_unique<SourceFile>(std::string(), std::string(In.readString()));
+    const auto NumIdentifiers = In.readVarint();
+    for (std::uint64_t Index = 0; Index < NumIdentifiers && !In.failed(); Index++) {
+        Identifiers.push_back(TyContext->getIdentifiers().get(In.readString()));
+    }
+
+    // Field types are set once the type table is read, as a field may have the type of a later struct.
+    std::vector<StructDecl*> Structs;
+    std::vector<std::uint64_t> FieldTypeRefs;
+    const auto NumStructs = In.readVarint();
+    for (std::uint64_t Index = 0; Index < NumStructs && !In.failed(); Index++) {
+        In.startRecord();
+        const auto NameID = readNameID(In);
+        const auto Identifier = readIdentifier(In);
+        std::vector<StructDeclField> Fields;
+        const auto NumFields = In.readVarint();
+        for (std::uint64_t Field = 0; Field < NumFields && !In.failed(); Field++) {
+            const auto FieldID = readNameID(In);
+            const auto FieldIdentifier = readIdentifier(In);
+            FieldTypeRefs.push_back(In.readVarint());
+            FieldTypeRefs.push_back(In.readVarint());
+            Fields.emplace_back(FieldIdentifier, FieldID, nullptr);
+        }
+        Structs.push_back(NodeArena->create<StructDecl>(Identifier, NameID, NodeArena->copyList(Fields)));
+        registerName(*Structs.back(), nullptr);
+    }
+    if (In.failed() || !readTypes(In, Structs)) {
+        fail("malformed type table");
+        return nullptr;
+    }
+    auto FieldTypeRef = FieldTypeRefs.begin();
+    for (const auto Struct : Structs) {
+        for (auto& Field : Struct->getFields()) {
+            const auto ResolvedType = lookupType(In, *FieldTypeRef++);
+            Field.FieldType = lookupType(In, *FieldTypeRef++);
+            registerName(Field, ResolvedType);
+        }
+    }
+
+    std::vector<AstPtr<Declaration>> Declarations;
+    std::vector<FunctionDecl*> Functions;
+    const auto NumDecls = In.readVarint();
+    for (std::uint64_t Index = 0; Index < NumDecls && !In.failed(); Index++) {
+        switch (static_cast<ModuleFormat::DeclKind>(In.readByte())) {
+        case ModuleFormat::DeclKind::Function:
+            Functions.push_back(readFunction(In));
+            Declarations.push_back(Functions.back());
+            break;
+        case ModuleFormat::DeclKind::Struct: {
+            const auto Struct = In.readVarint();
+            const auto Ty = readType(In);
+            if (Struct >= Structs.size()) {
+                In.fail();
+                break;
+            }
+            SemanInfo->setType(*Structs[Struct], Ty);
+            Declarations.push_back(Structs[Struct]);
+            break;
+        }
+        default:
+            In.fail();
+        }
+    }
+    if (In.failed() || !In.atEnd()) {
+        fail("malformed declarations");
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<Arena>> Arenas;
+    Arenas.push_back(std::move(OwnedArena));
+    auto Result = std::make_unique<Module>(std::move(Declarations), TyContext, *Source, std::move(Arenas));
+    Result->BodySource = this;
+    if (!Lazy) {
+        for (const auto Function : Functions) {
+            if (BodyOffsets.lookup(Function->getNameID()) != 0 && !loadBody(*Function)) {
+                return nullptr;
+            }
+        }
+    }
+    return Result;
+}
+
+bool ModuleReader::loadBody(FunctionDecl& Function) {
+    assert(!Function.isBodyParsed());
+    TraceScope Span("load body", Function.getName());
+    const auto Offset = BodyOffsets.lookup(Function.getNameID());
+    if (Offset == 0) {
+        return fail(std::format("'{}' was written without a body", Function.getName()));
+    }
+    if (Offset > Data.size() - BodiesOffset) {
+        return fail(std::format("malformed body of '{}'", Function.getName()));
+    }
+    Cursor In(Data.substr(BodiesOffset + Offset - 1));
+    In.NextName = static_cast<std::uint32_t>(In.readVarint());
+    const auto Body = readStmt(In);
+    for (const auto& [Expr, Ref] : In.Refs) {
+        if (Ref == 0) {
+            continue;
+        }
+        if (Ref > NumNames || Names[Ref - 1] == nullptr) {
+            In.fail();
+            break;
+        }
+        Expr->setRefedName(Names[Ref - 1]);
+    }
+    if (In.failed()) {
+        return fail(std::format("malformed body of '{}'", Function.getName()));
+    }
+    Function.setBody(Body);
+    return true;
+}
+
+bool ModuleReader::fail(std::string Message) {
+    Error = std::move(Message);
+    return false;
+}
+
+bool ModuleReader::readTypes(Cursor& In, std::span<StructDecl* const> Structs) {
+    const auto& BuiltinTypes = TyContext->getBuiltinTypes();
+    const auto NumTypes = In.readVarint();
+    for (std::uint64_t Index = 0; Index < NumTypes && !In.failed(); Index++) {
+        const Type* Ty = nullptr;
+        switch (static_cast<ModuleFormat::TypeKind>(In.readByte())) {
+        case ModuleFormat::TypeKind::Builtin: {
+            const auto Builtin = In.readVarint();
+            Ty = Builtin < BuiltinTypes.size() ? BuiltinTypes[Builtin] : nullptr;
+            break;
+        }
+        case ModuleFormat::TypeKind::Pointer:
+            if (const auto Element = readType(In)) {
+                Ty = TyContext->getPointerType(Element);
+            }
+            break;
+        case ModuleFormat::TypeKind::Array: {
+            const auto Element = readType(In);
+            const auto Size = In.readVarint();
+            if (Element != nullptr) {
+                Ty = TyContext->getArrayType(Element, Size);
+            }
+            break;
+        }
+        case ModuleFormat::TypeKind::Function: {
+            const auto ReturnType = readType(In);
+            std::vector<const Type*> ParamTypes;
+            const auto NumParams = In.readVarint();
+            for (std::uint64_t Param = 0; Param < NumParams && !In.failed(); Param++) {
+                ParamTypes.push_back(readType(In));
+            }
+            if (ReturnType != nullptr && std::ranges::find(ParamTypes, nullptr) == ParamTypes.end()) {
+                Ty = TyContext->getFunctionType(ReturnType, ParamTypes);
+            }
+            break;
+        }
+        case ModuleFormat::TypeKind::Struct: {
+            const auto Struct = In.readVarint();
+            if (Struct < Structs.size()) {
+                Ty = TyContext->createStructType(Structs[Struct]->getName(), *Structs[Struct]);
+            }
+            break;
+        }
+        case ModuleFormat::TypeKind::Unresolved: {
+            const auto Identifier = In.readVarint();
+            if (Identifier < Identifiers.size()) {
+                Ty = TyContext->createUnresolvedType(IdentifierSymbol(Identifiers[Identifier], {}));
+            }
+            break;
+        }
+        }
+        if (Ty == nullptr) {
+            In.fail();
+        }
+        Types.push_back(Ty);
+    }
+    return !In.failed();
+}
+
+const Type* ModuleReader::readType(Cursor& In) {
+    return lookupType(In, In.readVarint());
+}
+
+const Type* ModuleReader::lookupType(Cursor& In, std::uint64_t Ref) {
+    if (Ref > Types.size()) {
+        In.fail();
+        return nullptr;
+    }
+    return Ref != 0 ? Types[Ref - 1] : nullptr;
+}
+
+IdentifierSymbol ModuleReader::readIdentifier(Cursor& In) {
+    const auto Identifier = In.readVarint();
+    const auto Range = In.readRange();
+    if (Identifier >= Identifiers.size()) {
+        In.fail();
+        return { nullptr, Range };
+    }
+    return { Identifiers[Identifier], Range };
+}
+
+TypeInfo ModuleReader::readTypeInfo(Cursor& In) {
+    const auto Ty = readType(In);
+    return TypeInfo(Ty, In.readRange());
+}
+
+std::uint32_t ModuleReader::readNameID(Cursor& In) {
+    if (In.NextName >= NumNames) {
+        In.fail();
+        // Past the reserved block, so registerName ignores it.
+        return FirstNameID + NumNames;
+    }
+    return FirstNameID + In.NextName++;
+}
+
+void ModuleReader::registerName(const Nameable& Name, const Type* ResolvedType) {
+    const auto Index = Name.getNameID() - FirstNameID;
+    if (Index >= NumNames) {
+        return;
+    }
+    Names[Index] = &Name;
+    if (ResolvedType != nullptr) {
+        SemanInfo->setType(Name, ResolvedType);
+    }
+}
+
+AstPtr<FunctionDecl> ModuleReader::readFunction(Cursor& In) {
+    In.startRecord();
+    const auto NameID = readNameID(In);
+    const auto Identifier = readIdentifier(In);
+    const auto ResolvedType = readType(In);
+    const auto RetType = readType(In);
+    std::vector<FunctionDecl::Param> Params;
+    std::vector<const Type*> ParamResolvedTypes;
+    const auto NumParams = In.readVarint();
+    for (std::uint64_t Index = 0; Index < NumParams && !In.failed(); Index++) {
+        const auto ParamID = readNameID(In);
+        const auto ParamIdentifier = readIdentifier(In);
+        ParamResolvedTypes.push_back(readType(In));
+        Params.emplace_back(ParamIdentifier, ParamID, readType(In));
+    }
+    const auto BodyStart = In.readLoc();
+    const auto BodyOffset = In.readVarint();
+    if (RetType == nullptr || BodyOffset > Data.size()) {
+        In.fail();
+    }
+    const auto Function = NodeArena->create<FunctionDecl>(Identifier, NameID, RetType, NodeArena->copyList(Params),
+                                                          BodyStart);
+    registerName(*Function, ResolvedType);
+    for (size_t Index = 0; Index < Function->getParams().size(); Index++) {
+        registerName(Function->getParams()[Index], ParamResolvedTypes[Index]);
+    }
+    if (BodyOffset != 0 && !In.failed()) {
+        BodyOffsets[NameID] = static_cast<std::uint32_t>(BodyOffset);
+    }
+    return Function;
+}
+
+template <typename T>
+AstList<T> ModuleReader::readList(Cursor& In, AstPtr<T> (ModuleReader::*ReadElement)(Cursor&, bool)) {
+    std::vector<AstPtr<T>> Elements;
+    const auto Size = In.readVarint();
+    for (std::uint64_t Index = 0; Index < Size && !In.failed(); Index++) {
+        Elements.push_back((this->*ReadElement)(In, false));
+    }
+    return NodeArena->copyList(Elements);
+}
+
+AstPtr<Expression> ModuleReader::readExpr(Cursor& In, bool Optional) {
+    const auto Kind = static_cast<ModuleFormat::NodeKind>(In.readByte());
+    if (Kind == ModuleFormat::NodeKind::None) {
+        if (!Optional) {
+            In.fail();
+        }
+        return nullptr;
+    }
+    const auto Ty = readType(In);
+    AstPtr<Expression> Expr = nullptr;
+    // Nodes are created even after a failure; they stay in the arena unused.
+    switch (Kind) {
+    case ModuleFormat::NodeKind::Literal:
+        switch (static_cast<ModuleFormat::LiteralKind>(In.readByte())) {
+        case ModuleFormat::LiteralKind::Int: {
+            const IntLiteral Value{ In.readVarint() };
+            Expr = NodeArena->create<LiteralExpr>(Value, In.readRange());
+            break;
+        }
+        case ModuleFormat::LiteralKind::Float: {
+            const FloatLiteral Value{ std::bit_cast<double>(In.readFixed(8)) };
+            Expr = NodeArena->create<LiteralExpr>(Value, In.readRange());
+            break;
+        }
+        case ModuleFormat::LiteralKind::Bool: {
+            const BoolLiteral Value{ In.readByte() != 0 };
+            Expr = NodeArena->create<LiteralExpr>(Value, In.readRange());
+            break;
+        }
+        case ModuleFormat::LiteralKind::String:
+            Expr = NodeArena->create<LiteralExpr>(StringLiteral{}, In.readRange());
+            break;
+        default:
+            In.fail();
+            return nullptr;
+        }
+        break;
+    case ModuleFormat::NodeKind::BinaryOp: {
+        const auto Op = static_cast<TokenKind>(In.readVarint());
+        const auto Left = readExpr(In);
+        Expr = NodeArena->create<BinaryOpExpr>(Op, Left, readExpr(In));
+        break;
+    }
+    case ModuleFormat::NodeKind::UnaryOp: {
+        const auto StartLoc = In.readLoc();
+        const auto Op = static_cast<TokenKind>(In.readVarint());
+        Expr = NodeArena->create<UnaryOpExpr>(StartLoc, Op, readExpr(In));
+        break;
+    }
+    case ModuleFormat::NodeKind::FunctionCall: {
+        const auto Function = readExpr(In);
+        const auto Args = readList(In, &ModuleReader::readExpr);
+        Expr = NodeArena->create<FunctionCallExpr>(Function, Args, In.readLoc());
+        break;
+    }
+    case ModuleFormat::NodeKind::Named: {
+        const auto Named = NodeArena->create<NamedExpr>(readIdentifier(In));
+        In.Refs.emplace_back(Named, In.readVarint());
+        Expr = Named;
+        break;
+    }
+    case ModuleFormat::NodeKind::Dot: {
+        const auto Value = readExpr(In);
+        Expr = NodeArena->create<DotExpr>(Value, readIdentifier(In));
+        break;
+    }
+    case ModuleFormat::NodeKind::Cast: {
+        const auto TyInfo = readTypeInfo(In);
+        Expr = NodeArena->create<CastExpr>(TyInfo, readExpr(In));
+        break;
+    }
+    case ModuleFormat::NodeKind::Subscript: {
+        const auto Value = readExpr(In);
+        const auto Subscript = readExpr(In);
+        Expr = NodeArena->create<SubscriptExpr>(Value, Subscript, In.readLoc());
+        break;
+    }
+    case ModuleFormat::NodeKind::CompoundExpr: {
+        const auto Range = In.readRange();
+        Expr = NodeArena->create<CompoundExpr>(readList(In, &ModuleReader::readExpr), Range.Start, Range.End);
+        break;
+    }
+    default:
+        In.fail();
+        return nullptr;
+    }
+    Expr->setType(Ty);
+    return Expr;
+}
+
+AstPtr<Statement> ModuleReader::readStmt(Cursor& In, bool Optional) {
+    switch (static_cast<ModuleFormat::NodeKind>(In.readByte())) {
+    case ModuleFormat::NodeKind::None:
+        if (!Optional) {
+            In.fail();
+        }
+        return nullptr;
+    case ModuleFormat::NodeKind::If: {
+        const auto Condition = readExpr(In);
+        const auto TrueBlock = readStmt(In, true);
+        return NodeArena->create<IfStmt>(Condition, TrueBlock, readStmt(In, true));
+    }
+    case ModuleFormat::NodeKind::Let: {
+        const auto NameID = readNameID(In);
+        const auto Identifier = readIdentifier(In);
+        const auto ResolvedType = readType(In);
+        const auto TyInfo = readTypeInfo(In);
+        const auto Let = NodeArena->create<LetStmt>(Identifier, NameID, TyInfo, readExpr(In, true));
+        registerName(*Let, ResolvedType);
+        return Let;
+    }
+    case ModuleFormat::NodeKind::While: {
+        const auto Condition = readExpr(In);
+        return NodeArena->create<WhileStmt>(Condition, readStmt(In));
+    }
+    case ModuleFormat::NodeKind::ExpressionStmt:
+        return NodeArena->create<ExpressionStmt>(readExpr(In));
+    case ModuleFormat::NodeKind::CompoundStmt:
+        return NodeArena->create<CompoundStmt>(readList(In, &ModuleReader::readStmt));
+    case ModuleFormat::NodeKind::Return:
+        return NodeArena->create<ReturnStmt>(readExpr(In, true));
+    case ModuleFormat::NodeKind::Assign: {
+        const auto Left = readExpr(In);
+        return NodeArena->create<AssignStmt>(Left, readExpr(In));
+    }
+    default:
+        In.fail();
+        return nullptr;
+    }
+}
\ No newline at end of file
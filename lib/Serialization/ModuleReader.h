@@ -0,0 +1,72 @@
+#pragma once
+#include "AST/Module.h"
+#include "Utils/DenseTable.h"
+#include "Utils/SourceBuffer.h"
+#include "Utils/SourceFile.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Seman;
+
+// Loads a module written by writeModule. The file is memory mapped and the declarations are read up front,
+// but a body can stay in the mapping until something needs it: with lazy loading, Seman::visitReachable reads
+// just the bodies reachable from its roots. Nodes come back as Seman left them, so a loaded module goes
+// straight to CodeGen with the Seman it was read into, and the frontend never runs.
+//
+// The module refers to the reader's source file and mapping, so the reader must outlive it. Source locations
+// are those of the original file, whose text is not stored.
+class ModuleReader final : public ExternalBodySource {
+public:
+    // Returns null, with the reason in Error, if Path cannot be read or is not a module of this version.
+    static std::unique_ptr<ModuleReader> open(const std::string& Path, std::string& Error);
+    ~ModuleReader() override;
+
+    // Creates the module's types in TyContext and records the resolved types of its names in SemanInfo, which
+    // must use the same TypeContext. Unless Lazy, every body is read as well. Returns null if the file is
+    // malformed (see getError). May only be called once.
+    std::unique_ptr<Module> read(std::shared_ptr<TypeContext> TyContext, Seman& SemanInfo, bool Lazy = true);
+    bool loadBody(FunctionDecl& Function) override;
+    const std::string& getError() const override { return Error; }
+
+private:
+    class Cursor;
+
+    ModuleReader(std::unique_ptr<SourceBuffer> Buffer, std::uint32_t NumNames, std::uint32_t BodiesOffset);
+    bool fail(std::string Message);
+    IdentifierSymbol readIdentifier(Cursor& In);
+    const Type* readType(Cursor& In);
+    // Ref is a type as written: an index in the type table plus one, or zero for none.
+    const Type* lookupType(Cursor& In, std::uint64_t Ref);
+    TypeInfo readTypeInfo(Cursor& In);
+    // Takes the next number in In for a name and returns its NameID.
+    std::uint32_t readNameID(Cursor& In);
+    void registerName(const Nameable& Name, const Type* ResolvedType);
+    bool readTypes(Cursor& In, std::span<StructDecl* const> Structs);
+    AstPtr<FunctionDecl> readFunction(Cursor& In);
+    // Unless Optional, a missing node fails In.
+    AstPtr<Expression> readExpr(Cursor& In, bool Optional = false);
+    AstPtr<Statement> readStmt(Cursor& In, bool Optional = false);
+    template <typename T>
+    AstList<T> readList(Cursor& In, AstPtr<T> (ModuleReader::*ReadElement)(Cursor&, bool));
+
+    std::unique_ptr<SourceBuffer> Buffer;
+    std::string_view Data;
+    std::uint32_t NumNames;
+    std::uint32_t BodiesOffset;
+    std::unique_ptr<SourceFile> Source;
+    std::shared_ptr<TypeContext> TyContext;
+    Seman* SemanInfo = nullptr;
+    Arena* NodeArena = nullptr;
+    std::uint32_t FirstNameID = 0;
+    std::vector<const IdentifierInfo*> Identifiers;
+    std::vector<const Type*> Types;
+    // Indexed by name number; a let is added when its body is read.
+    std::vector<const Nameable*> Names;
+    // Offset in the bodies section plus one, by function NameID.
+    DenseTable<std::uint32_t> BodyOffsets;
+    std::string Error;
+};
\ No newline at end of file
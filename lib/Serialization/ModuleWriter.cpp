@@ -0,0 +1,462 @@
+#include "ModuleWriter.h"
+#include "ModuleFormat.h"
+#include "AST/ASTVisitor.h"
+#include "Seman/Seman.h"
+#include "Utils/DenseTable.h"
+#include "Utils/SourceFile.h"
+#include "Utils/TimeReport.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+    // Appends the encodings described in ModuleFormat.h.
+    class ByteWriter {
+    public:
+        void writeByte(std::uint8_t Byte) { Bytes += static_cast<char>(Byte); }
+
+        void writeVarint(std::uint64_t Value) {
+            while (Value >= 0x80) {
+                writeByte(static_cast<std::uint8_t>(Value | 0x80));
+                Value >>= 7;
+            }
+            writeByte(static_cast<std::uint8_t>(Value));
+        }
+
+        void writeFixed(std::uint64_t Value, unsigned Size) {
+            for (unsigned Index = 0; Index < Size; Index++) {
+                writeByte(static_cast<std::uint8_t>(Value >> (Index * 8)));
+            }
+        }
+
+        void writeString(std::string_view Str) {
+            writeVarint(Str.size());
+            Bytes += Str;
+        }
+
+        void writeLoc(SourceLoc Loc) {
+            // Zigzag, so small negative differences stay short too.
+            const auto Delta = static_cast<std::int64_t>(Loc.Offset) - LastOffset;
+            writeVarint(static_cast<std::uint64_t>(Delta) << 1 ^ static_cast<std::uint64_t>(Delta >> 63));
+            LastOffset = Loc.Offset;
+        }
+
+        void writeRange(const SourceRange& Range) {
+            writeLoc(Range.Start);
+            writeLoc(Range.End);
+        }
+
+        // Locations in a record do not depend on anything written before it, so it can be decoded on its own.
+        void startRecord() { LastOffset = 0; }
+
+        std::string Bytes;
+    private:
+        std::int64_t LastOffset = 0;
+    };
+
+    // Builds the sections of a module file. The visits encode one statement or expression, with its children,
+    // into the bodies section.
+    class ModuleEncoder : public AstConstVisitor {
+    public:
+        ModuleEncoder(const Seman& SemanInfo) : SemanInfo(SemanInfo),
+            BuiltinTypes(SemanInfo.getTyContext().getBuiltinTypes()) {
+        }
+
+        std::string encode(const Module& Module);
+
+        void visit(const LiteralExpr&) override;
+        void visit(const UnaryOpExpr&) override;
+        void visit(const BinaryOpExpr&) override;
+        void visit(const FunctionCallExpr&) override;
+        void visit(const NamedExpr&) override;
+        void visit(const DotExpr&) override;
+        void visit(const CastExpr&) override;
+        void visit(const SubscriptExpr&) override;
+        void visit(const CompoundExpr&) override;
+
+        void visit(const IfStmt&) override;
+        void visit(const WhileStmt&) override;
+        void visit(const CompoundStmt&) override;
+        void visit(const ReturnStmt&) override;
+        void visit(const LetStmt&) override;
+        void visit(const ExpressionStmt&) override;
+        void visit(const AssignStmt&) override;
+
+    private:
+        void numberName(const Nameable& Name);
+        std::uint32_t addIdentifier(const IdentifierInfo* Info);
+        std::uint32_t addType(const Type* Ty);
+        void writeIdentifier(ByteWriter& Out, const IdentifierSymbol& Identifier);
+        void writeType(ByteWriter& Out, const Type* Ty) { Out.writeVarint(addType(Ty)); }
+        void writeTypeInfo(ByteWriter& Out, const TypeInfo& TyInfo);
+        // The identifier and the type Seman resolved for it.
+        void writeName(ByteWriter& Out, const Nameable& Name);
+        void writeExprStart(ModuleFormat::NodeKind Kind, const Expression& Expr);
+        void writeChild(const AstBase* Node);
+        void writeFunction(const FunctionDecl& Function);
+
+        const Seman& SemanInfo;
+        const std::vector<const Type*>& BuiltinTypes;
+        ByteWriter Identifiers, Structs, Types, Decls, Bodies;
+        std::uint32_t NumIdentifiers = 0;
+        std::uint32_t NumTypes = 0;
+        std::uint32_t NumNames = 0;
+        // Each holds an index plus one, so zero means not written yet.
+        DenseTable<std::uint32_t> IdentifierRefs;
+        DenseTable<std::uint32_t> TypeRefs;
+        DenseTable<std::uint32_t> NameRefs;
+        DenseTable<std::uint32_t> StructRefs;
+    };
+}
+
+std::string ModuleEncoder::encode(const Module& Module) {
+    std::vector<const StructDecl*> StructDecls;
+    for (const auto Decl : Module.getDeclarations()) {
+        if (const auto Struct = dynamic_cast<const StructDecl*>(Decl)) {
+            StructDecls.push_back(Struct);
+        }
+    }
+    // Every name a body can refer to is numbered before any body is written.
+    for (std::uint32_t Index = 0; Index < StructDecls.size(); Index++) {
+        StructRefs[StructDecls[Index]->getNameID()] = Index + 1;
+        numberName(*StructDecls[Index]);
+        for (const auto& Field : StructDecls[Index]->getFields()) {
+            numberName(Field);
+        }
+    }
+    for (const auto Decl : Module.getDeclarations()) {
+        if (const auto Function = dynamic_cast<const FunctionDecl*>(Decl)) {
+            numberName(*Function);
+            for (const auto& Param : Function->getParams()) {
+                numberName(Param);
+            }
+        }
+    }
+
+    for (const auto Struct : StructDecls) {
+        Structs.startRecord();
+        writeIdentifier(Structs, Struct->getIdentifier());
+        Structs.writeVarint(Struct->getFields().size());
+        for (const auto& Field : Struct->getFields()) {
+            writeName(Structs, Field);
+            writeType(Structs, Field.FieldType);
+        }
+    }
+    for (const auto Decl : Module.getDeclarations()) {
+        if (const auto Function = dynamic_cast<const FunctionDecl*>(Decl)) {
+            writeFunction(*Function);
+        } else {
+            const auto& Struct = static_cast<const StructDecl&>(*Decl);
+            Decls.writeByte(static_cast<std::uint8_t>(ModuleFormat::DeclKind::Struct));
+            Decls.writeVarint(StructRefs.lookup(Struct.getNameID()) - 1);
+            writeType(Decls, SemanInfo.getType(Struct));
+        }
+    }
+
+    ByteWriter File;
+    File.Bytes = ModuleFormat::Magic;
+    File.writeFixed(ModuleFormat::Version, 4);
+    File.writeFixed(NumNames, 4);
+    // The offset of the bodies section, filled in below.
+    File.writeFixed(0, 4);
+    File.writeString(Module.getSourceFile().getSourcePath());
+    File.writeVarint(NumIdentifiers);
+    File.Bytes += Identifiers.Bytes;
+    File.writeVarint(StructDecls.size());
+    File.Bytes += Structs.Bytes;
+    File.writeVarint(NumTypes);
+    File.Bytes += Types.Bytes;
+    File.writeVarint(Module.getDeclarations().size());
+    File.Bytes += Decls.Bytes;
+    assert(File.Bytes.size() + Bodies.Bytes.size() <= std::numeric_limits<std::uint32_t>::max());
+    const auto BodiesOffset = static_cast<std::uint32_t>(File.Bytes.size());
+    for (unsigned Index = 0; Index < 4; Index++) {
+        File.Bytes[ModuleFormat::HeaderSize - 4 + Index] = static_cast<char>(BodiesOffset >> (Index * 8));
+    }
+    File.Bytes += Bodies.Bytes;
+    return std::move(File.Bytes);
+}
+
+void ModuleEncoder::writeFunction(const FunctionDecl& Function) {
+    Decls.writeByte(static_cast<std::uint8_t>(ModuleFormat::DeclKind::Function));
+    Decls.startRecord();
+    writeName(Decls, Function);
+    writeType(Decls, &Function.getRetType());
+    Decls.writeVarint(Function.getParams().size());
+    for (const auto& Param : Function.getParams()) {
+        writeName(Decls, Param);
+        writeType(Decls, Param.ParamType);
+    }
+    Decls.writeLoc(Function.getBodyStart());
+    // A body a lazy parse skipped was never checked, so the function is written as a declaration.
+    if (!Function.isBodyParsed()) {
+        Decls.writeVarint(0);
+        return;
+    }
+    Decls.writeVarint(Bodies.Bytes.size() + 1);
+    Bodies.startRecord();
+    Bodies.writeVarint(NumNames);
+    Function.getBody().accept(*this);
+}
+
+void ModuleEncoder::numberName(const Nameable& Name) {
+    NameRefs[Name.getNameID()] = ++NumNames;
+}
+
+std::uint32_t ModuleEncoder::addIdentifier(const IdentifierInfo* Info) {
+    auto& Ref = IdentifierRefs[Info->getID()];
+    if (Ref == 0) {
+        Identifiers.writeString(Info->getName());
+        Ref = ++NumIdentifiers;
+    }
+    return Ref - 1;
+}
+
+std::uint32_t ModuleEncoder::addType(const Type* Ty) {
+    if (Ty == nullptr) {
+        return 0;
+    }
+    if (const auto Ref = TypeRefs.lookup(Ty->getID())) {
+        return Ref;
+    }
+    // The types an entry is built from are added first, so the reader has them when it gets to the entry.
+    switch (Ty->getTag()) {
+    case TypeTag::Primitive:
+    case TypeTag::Integer:
+    case TypeTag::FloatingPoint: {
+        const auto Index = std::ranges::find(BuiltinTypes, Ty) - BuiltinTypes.begin();
+        assert(Index < static_cast<std::ptrdiff_t>(BuiltinTypes.size()));
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Builtin));
+        Types.writeVarint(Index);
+        break;
+    }
+    case TypeTag::Pointer: {
+        const auto Element = addType(Ty->as<PointerType>().getElementType());
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Pointer));
+        Types.writeVarint(Element);
+        break;
+    }
+    case TypeTag::Array: {
+        const auto& ArrayTy = Ty->as<ArrayType>();
+        const auto Element = addType(ArrayTy.getElementType());
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Array));
+        Types.writeVarint(Element);
+        Types.writeVarint(ArrayTy.getSize());
+        break;
+    }
+    case TypeTag::Function: {
+        const auto& FunctionTy = Ty->as<FunctionType>();
+        const auto Return = addType(FunctionTy.getReturnType());
+        std::vector<std::uint32_t> Params;
+        for (const auto Param : FunctionTy.getParamTypes()) {
+            Params.push_back(addType(Param));
+        }
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Function));
+        Types.writeVarint(Return);
+        Types.writeVarint(Params.size());
+        for (const auto Param : Params) {
+            Types.writeVarint(Param);
+        }
+        break;
+    }
+    case TypeTag::Struct: {
+        // Only the struct types of this module's declarations can be written.
+        const auto Struct = StructRefs.lookup(Ty->as<StructType>().getDecl().getNameID());
+        assert(Struct != 0);
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Struct));
+        Types.writeVarint(Struct - 1);
+        break;
+    }
+    case TypeTag::Unresolved: {
+        const auto Identifier = addIdentifier(Ty->as<UnresolvedType>().getIdentifier().getInfo());
+        Types.writeByte(static_cast<std::uint8_t>(ModuleFormat::TypeKind::Unresolved));
+        Types.writeVarint(Identifier);
+        break;
+    }
+    }
+    TypeRefs[Ty->getID()] = ++NumTypes;
+    return NumTypes;
+}
+
+void ModuleEncoder::writeIdentifier(ByteWriter& Out, const IdentifierSymbol& Identifier) {
+    Out.writeVarint(addIdentifier(Identifier.getInfo()));
+    Out.writeRange(Identifier.getRange());
+}
+
+void ModuleEncoder::writeTypeInfo(ByteWriter& Out, const TypeInfo& TyInfo) {
+    writeType(Out, TyInfo.getType());
+    Out.writeRange(TyInfo.getRange());
+}
+
+void ModuleEncoder::writeName(ByteWriter& Out, const Nameable& Name) {
+    writeIdentifier(Out, Name.getIdentifier());
+    writeType(Out, SemanInfo.getType(Name));
+}
+
+void ModuleEncoder::writeExprStart(ModuleFormat::NodeKind Kind, const Expression& Expr) {
+    Bodies.writeByte(static_cast<std::uint8_t>(Kind));
+    writeType(Bodies, Expr.getType());
+}
+
+void ModuleEncoder::writeChild(const AstBase* Node) {
+    if (Node == nullptr) {
+        Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::None));
+        return;
+    }
+    Node->accept(*this);
+}
+
+void ModuleEncoder::visit(const LiteralExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::Literal, Node);
+    if (Node.is<IntLiteral>()) {
+        Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::LiteralKind::Int));
+        Bodies.writeVarint(Node.as<IntLiteral>().Value);
+    } else if (Node.is<FloatLiteral>()) {
+        Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::LiteralKind::Float));
+        Bodies.writeFixed(std::bit_cast<std::uint64_t>(Node.as<FloatLiteral>().Value), 8);
+    } else if (Node.is<BoolLiteral>()) {
+        Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::LiteralKind::Bool));
+        Bodies.writeByte(Node.as<BoolLiteral>().Value);
+    } else {
+        Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::LiteralKind::String));
+    }
+    Bodies.writeRange(Node.getRange());
+}
+
+void ModuleEncoder::visit(const UnaryOpExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::UnaryOp, Node);
+    Bodies.writeLoc(Node.getStart());
+    Bodies.writeVarint(static_cast<std::uint64_t>(Node.getKind()));
+    writeChild(&Node.getValue());
+}
+
+void ModuleEncoder::visit(const BinaryOpExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::BinaryOp, Node);
+    Bodies.writeVarint(static_cast<std::uint64_t>(Node.getKind()));
+    writeChild(&Node.getLeft());
+    writeChild(&Node.getRight());
+}
+
+void ModuleEncoder::visit(const FunctionCallExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::FunctionCall, Node);
+    writeChild(&Node.getFunction());
+    Bodies.writeVarint(Node.getArgs().size());
+    for (const auto Arg : Node.getArgs()) {
+        writeChild(Arg);
+    }
+    Bodies.writeLoc(Node.getEnd());
+}
+
+void ModuleEncoder::visit(const NamedExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::Named, Node);
+    writeIdentifier(Bodies, Node.getIdentifier());
+    const auto Ref = Node.getRefedName();
+    assert(Ref == nullptr || NameRefs.lookup(Ref->getNameID()) != 0);
+    Bodies.writeVarint(Ref != nullptr ? NameRefs.lookup(Ref->getNameID()) : 0);
+}
+
+void ModuleEncoder::visit(const DotExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::Dot, Node);
+    writeChild(&Node.getExpr());
+    writeIdentifier(Bodies, Node.getIdentifier());
+}
+
+void ModuleEncoder::visit(const CastExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::Cast, Node);
+    writeTypeInfo(Bodies, Node.getTypeInfo());
+    writeChild(&Node.getValue());
+}
+
+void ModuleEncoder::visit(const SubscriptExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::Subscript, Node);
+    writeChild(&Node.getExpr());
+    writeChild(&Node.getSubscript());
+    Bodies.writeLoc(Node.getEnd());
+}
+
+void ModuleEncoder::visit(const CompoundExpr& Node) {
+    writeExprStart(ModuleFormat::NodeKind::CompoundExpr, Node);
+    Bodies.writeRange(Node.getRange());
+    Bodies.writeVarint(Node.getExprs().size());
+    for (const auto Expr : Node.getExprs()) {
+        writeChild(Expr);
+    }
+}
+
+void ModuleEncoder::visit(const IfStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::If));
+    writeChild(&Node.getCondition());
+    writeChild(Node.getTrueBlock());
+    writeChild(Node.getFalseBlock());
+}
+
+void ModuleEncoder::visit(const WhileStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::While));
+    writeChild(&Node.getCondition());
+    writeChild(&Node.getBody());
+}
+
+void ModuleEncoder::visit(const CompoundStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::CompoundStmt));
+    Bodies.writeVarint(Node.getBody().size());
+    for (const auto Stmt : Node.getBody()) {
+        writeChild(Stmt);
+    }
+}
+
+void ModuleEncoder::visit(const ReturnStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::Return));
+    writeChild(Node.getValue());
+}
+
+void ModuleEncoder::visit(const LetStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::Let));
+    // Numbered before the value, which is in the let's scope.
+    numberName(Node);
+    writeName(Bodies, Node);
+    writeTypeInfo(Bodies, Node.getTypeInfo());
+    writeChild(Node.getValue());
+}
+
+void ModuleEncoder::visit(const ExpressionStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::ExpressionStmt));
+    writeChild(&Node.getExpr());
+}
+
+void ModuleEncoder::visit(const AssignStmt& Node) {
+    Bodies.writeByte(static_cast<std::uint8_t>(ModuleFormat::NodeKind::Assign));
+    writeChild(&Node.getLeft());
+    writeChild(&Node.getRight());
+}
+
+std::string writeModule(const Module& Module, const Seman& SemanInfo) {
+    TimeScope Scope("write module");
+    ModuleEncoder Encoder(SemanInfo);
+    return Encoder.encode(Module);
+}
+
+bool writeModuleFile(const Module& Module, const Seman& SemanInfo, const std::string& Path) {
+    const auto Data = writeModule(Module, SemanInfo);
+    const auto TempPath = Path + ".tmp";
+    {
+        std::ofstream Out(TempPath, std::ios::binary | std::ios::trunc);
+        Out.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+        if (!Out) {
+            std::error_code EC;
+            std::filesystem::remove(TempPath, EC);
+            return false;
+        }
+    }
+    // A reader that mapped the old file keeps its pages; the rename only changes what the path names.
+    std::error_code EC;
+    std::filesystem::rename(TempPath, Path, EC);
+    if (EC) {
+        std::filesystem::remove(TempPath, EC);
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+
+class Module;
+class Seman;
+
+// Serializes Module together with what SemanInfo recorded for it (see ModuleFormat.h), for ModuleReader. The
+// module must have been checked by SemanInfo without errors; a function whose body a lazy parse skipped is
+// written as a declaration.
+std::string writeModule(const Module& Module, const Seman& SemanInfo);
+// Writes it to a temporary file renamed to Path, so a reader never maps a partial module. Returns false if the
+// file cannot be written.
+bool writeModuleFile(const Module& Module, const Seman& SemanInfo, const std::string& Path);
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "Arena.h"
+#include <cstdint>
+#include <ranges>
+
+Arena::~Arena() {
+    for (const auto& [Obj, Destroy] : Destructors | std::views::reverse) {
+        Destroy(Obj);
+    }
+}
+
+void* Arena::allocate(size_t Size, size_t Align) {
+    const auto alignUp = [Align](std::byte* Ptr) {
+        const auto Addr = reinterpret_cast<std::uintptr_t>(Ptr);
+        return reinterpret_cast<std::byte*>((Addr + Align - 1) & ~(Align - 1));
+    };
+    BytesAllocated += Size;
+
+    if (Cur != nullptr) {
+        if (const auto Aligned = alignUp(Cur); Aligned + Size <= End) {
+            Cur = Aligned + Size;
+            return Aligned;
+        }
+    }
+
+    // Oversized requests get a slab of their own so the current one keeps its free space.
+    const auto NewSlabSize = Size + Align > SlabSize ? Size + Align : SlabSize;
+    Slabs.push_back(std::make_unique_for_overwrite<std::byte[]>(NewSlabSize));
+    BytesReserved += NewSlabSize;
+    const auto Begin = Slabs.back().get();
+    const auto Aligned = alignUp(Begin);
+    if (NewSlabSize == SlabSize) {
+        Cur = Aligned + Size;
+        End = Begin + NewSlabSize;
+    }
+    return Aligned;
+}
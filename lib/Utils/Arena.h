@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump-pointer allocator. Memory is released all at once when the arena
+// is destroyed; objects that are not trivially destructible have their
+// destructors run at that point, everything else is simply dropped.
+class Arena {
+public:
+    Arena() = default;
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t Size, size_t Align);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... Arguments) {
+        auto Ptr = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(Arguments)...);
+        registerDestructor(Ptr);
+        NumObjects++;
+        return Ptr;
+    }
+
+    // Moves the elements into arena memory.
+    template <typename T>
+    std::span<T> copyList(std::vector<T>& Elems) {
+        if (Elems.empty()) {
+            return {};
+        }
+        const auto Ptr = static_cast<T*>(allocate(sizeof(T) * Elems.size(), alignof(T)));
+        for (size_t Index = 0; Index < Elems.size(); Index++) {
+            registerDestructor(new (Ptr + Index) T(std::move(Elems[Index])));
+        }
+        return { Ptr, Elems.size() };
+    }
+
+    size_t getNumObjects() const { return NumObjects; }
+    size_t getBytesAllocated() const { return BytesAllocated; }
+    size_t getBytesReserved() const { return BytesReserved; }
+    size_t getNumSlabs() const { return Slabs.size(); }
+    size_t getNumDestructors() const { return Destructors.size(); }
+
+private:
+    template <typename T>
+    void registerDestructor(T* Ptr) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            Destructors.emplace_back(Ptr, [](void* Obj) { static_cast<T*>(Obj)->~T(); });
+        }
+    }
+
+    static constexpr size_t SlabSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> Slabs;
+    std::byte* Cur = nullptr;
+    std::byte* End = nullptr;
+    std::vector<std::pair<void*, void (*)(void*)>> Destructors;
+    size_t NumObjects = 0;
+    size_t BytesAllocated = 0;
+    size_t BytesReserved = 0;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Side table keyed by a dense ID such as Type::getID or Nameable::getNameID.
+// lookup returns a value-initialized Value for IDs that were never set.
+template <typename Value>
+class DenseTable {
+public:
+    Value lookup(std::uint32_t ID) const {
+        return ID < Values.size() ? Values[ID] : Value{};
+    }
+    Value& operator[](std::uint32_t ID) {
+        if (ID >= Values.size()) {
+            Values.resize(ID + 1);
+        }
+        return Values[ID];
+    }
+    void reserve(std::uint32_t Size) { Values.reserve(Size); }
+private:
+    std::vector<Value> Values;
+};
\ No newline at end of file
@@ -13,7 +13,7 @@ enum class UnderlineState : std::uint8_t {
 };
 
 
-std::vector<std::string> createUnderlines(std::span<std::string_view> Lines, const SourceRange& Loc) {
+std::vector<std::string> createUnderlines(const std::vector<std::string_view>& Lines, LineColumn Start, LineColumn End) {
     unsigned LineIndex = 0;
     auto State = UnderlineState::Not;
     auto NumLines = Lines.size();
@@ -26,10 +26,10 @@ std::vector<std::string> createUnderlines(std::span<std::string_view> Lines, con
         for (unsigned Idx = 0; Idx < Line.size(); Idx++) {
             switch (State) {
                 case UnderlineState::Not:
-                    if (Loc.Start.Column == Idx) {
+                    if (Start.Column == Idx) {
                         Underline << "^";
                         State = UnderlineState::Middle;
-                        if (IsLastLine && Idx == Loc.End.Column) {
+                        if (IsLastLine && Idx == End.Column) {
                             State = UnderlineState::Done;
                         }
                     }
@@ -43,7 +43,7 @@ std::vector<std::string> createUnderlines(std::span<std::string_view> Lines, con
                     }
                     break;
                 case UnderlineState::Middle:
-                    if (IsLastLine && Idx == Loc.End.Column) {
+                    if (IsLastLine && Idx == End.Column) {
                         State = UnderlineState::Done;
                         break;
                     }
@@ -64,15 +64,15 @@ std::vector<std::string> createUnderlines(std::span<std::string_view> Lines, con
     return Ret;
 }
 
-std::vector<std::string> createLineNumPrefix(const SourceRange& Loc, std::string& UnderlinePrefix) {
+std::vector<std::string> createLineNumPrefix(LineColumn Start, LineColumn End, std::string& UnderlinePrefix) {
     auto IntLength = [](auto Int) {
         return std::to_string(Int).size();
     };
-    auto Width = IntLength(Loc.End.LineNum);
+    auto Width = IntLength(End.LineNum);
     std::vector<std::string> Ret;
 
     UnderlinePrefix = std::format("{:>{}} | ", "", Width);
-    for (auto LineNum = Loc.Start.LineNum; LineNum <= Loc.End.LineNum; LineNum++) {
+    for (auto LineNum = Start.LineNum; LineNum <= End.LineNum; LineNum++) {
         auto Prefix = std::format("{:>{}} | ", LineNum, Width);
         Ret.push_back(Prefix);
     }
@@ -80,22 +80,30 @@ std::vector<std::string> createLineNumPrefix(const SourceRange& Loc, std::string
 }
 
 void ErrorReporter::error(SourceFile& Source, const SourceRange& Loc, const std::string& Message) {
-    auto Msg = std::format("error: {}:{}:{}: {}", Source.getSourcePath(), Loc.Start.LineNum, Loc.Start.Column + 1, Message);
-    std::cout << Msg << '\n';
+    ++NumErrors;
+    const auto Start = Source.getLineColumn(Loc.Start);
+    const auto End = Source.getLineColumn(Loc.End);
+    auto Msg = std::format("error: {}:{}:{}: {}", Source.getSourcePath(), Start.LineNum, Start.Column + 1, Message);
+    Out << Msg << '\n';
     auto SourceLines = Source.getSourceFromRange(Loc);
-    auto Underlines = createUnderlines(SourceLines, Loc);
+    auto Underlines = createUnderlines(SourceLines, Start, End);
     std::string UnderlinePrefix;
-    auto LineNumPrefix = createLineNumPrefix(Loc, UnderlinePrefix);
+    auto LineNumPrefix = createLineNumPrefix(Start, End, UnderlinePrefix);
 
     for (unsigned Idx = 0; Idx < SourceLines.size(); Idx++) {
-        std::cout << LineNumPrefix[Idx];
+        Out << LineNumPrefix[Idx];
         for (auto Chr : SourceLines[Idx]) {
-            if (Chr == '\t') std::cout << "    ";
-            else std::cout << Chr;
+            if (Chr == '\t') Out << "    ";
+            else Out << Chr;
         }
-        std::cout << '\n';
-        std::cout << UnderlinePrefix;
-        std::cout << Underlines[Idx] << '\n';
+        Out << '\n';
+        Out << UnderlinePrefix;
+        Out << Underlines[Idx] << '\n';
     }
-    std::cout << '\n';
+    Out << '\n';
+}
+
+void ErrorReporter::error(const SourceFile& Source, const std::string& Message) {
+    ++NumErrors;
+    Out << std::format("error: {}: {}", Source.getSourcePath(), Message) << "\n\n";
 }
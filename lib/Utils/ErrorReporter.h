@@ -1,8 +1,17 @@
 #pragma once
 #include "SourceFile.h"
 #include "SourceLoc.h"
+#include <iostream>
+#include <ostream>
 
 class ErrorReporter {
 public:
+    explicit ErrorReporter(std::ostream& Out = std::cout) : Out(Out) {}
     void error(SourceFile& Source, const SourceRange& Loc, const std::string& Message);
+    // For errors that belong to no location in Source, such as a body a ModuleReader cannot read.
+    void error(const SourceFile& Source, const std::string& Message);
+    std::size_t getNumErrors() const { return NumErrors; }
+private:
+    std::ostream& Out;
+    std::size_t NumErrors = 0;
 };
\ No newline at end of file
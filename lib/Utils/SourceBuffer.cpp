@@ -0,0 +1,82 @@
+#include "SourceBuffer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define UNL_HAS_MMAP
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace {
+    class StringSourceBuffer final : public SourceBuffer {
+    public:
+        explicit StringSourceBuffer(std::string Str) : Storage(std::move(Str)) {
+            Contents = Storage;
+        }
+    private:
+        std::string Storage;
+    };
+
+#ifdef UNL_HAS_MMAP
+    class MappedSourceBuffer final : public SourceBuffer {
+    public:
+        MappedSourceBuffer(void* Address, size_t Size) : Address(Address), Size(Size) {
+            Contents = { static_cast<const char*>(Address), Size };
+        }
+        ~MappedSourceBuffer() override {
+            munmap(Address, Size);
+        }
+        bool isMapped() const override { return true; }
+    private:
+        void* Address;
+        size_t Size;
+    };
+
+    std::string readAll(int Fd) {
+        std::string Ret;
+        char Chunk[1 << 16];
+        ssize_t Count;
+        while ((Count = read(Fd, Chunk, sizeof(Chunk))) != 0) {
+            if (Count < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            Ret.append(Chunk, Count);
+        }
+        return Ret;
+    }
+#endif
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromString(std::string Contents) {
+    return std::make_unique<StringSourceBuffer>(std::move(Contents));
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromFile(const std::string& Path) {
+#ifdef UNL_HAS_MMAP
+    const int Fd = open(Path.c_str(), O_RDONLY);
+    if (Fd < 0) {
+        return fromString("");
+    }
+    struct stat Stat{};
+    if (fstat(Fd, &Stat) == 0 && S_ISREG(Stat.st_mode) && Stat.st_size > 0) {
+        const auto Size = static_cast<size_t>(Stat.st_size);
+        void* Address = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Fd, 0);
+        if (Address != MAP_FAILED) {
+            close(Fd);
+            return std::make_unique<MappedSourceBuffer>(Address, Size);
+        }
+    }
+    auto Contents = readAll(Fd);
+    close(Fd);
+    return fromString(std::move(Contents));
+#else
+    std::ifstream File(Path);
+    return fromString(std::string(std::istreambuf_iterator(File), std::istreambuf_iterator<char>()));
+#endif
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only contents of a source file. Regular files are memory mapped
+// where the platform allows it, so the lexer works on the mapped pages
+// directly; anything else (pipes, /dev/stdin) is read into memory.
+class SourceBuffer {
+public:
+    virtual ~SourceBuffer() = default;
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    static std::unique_ptr<SourceBuffer> fromString(std::string Contents);
+    static std::unique_ptr<SourceBuffer> fromFile(const std::string& Path);
+
+    std::string_view getContents() const { return Contents; }
+    virtual bool isMapped() const { return false; }
+protected:
+    SourceBuffer() = default;
+    std::string_view Contents;
+};
@@ -1,19 +1,51 @@
 #include "SourceFile.h"
 #include <algorithm>
+#include <iterator>
 
-SourceFile::SourceFile(std::string SrcString, std::string SourcePath): SourceCode(std::move(SrcString)), SourcePath(std::move(SourcePath)) {
-    auto Left = SourceCode.begin();
-    while (Left != SourceCode.end()) {
-        auto Right = std::find(Left, SourceCode.end(), '\n');
-        SourceLines.emplace_back(Left, Right);
-        if (Right != SourceCode.end()) {
-            ++Right;
+SourceFile::SourceFile(std::string SrcString, std::string SourcePath) :
+    SourceFile(SourceBuffer::fromString(std::move(SrcString)), std::move(SourcePath)) {
+}
+
+SourceFile::SourceFile(std::unique_ptr<SourceBuffer> Buffer, std::string SourcePath) :
+    Buffer(std::move(Buffer)), SourcePath(std::move(SourcePath)) {
+}
+
+const std::vector<std::uint32_t>& SourceFile::getLineOffsets() const {
+    std::call_once(LineOffsetsBuilt, [this] {
+        const auto SourceCode = getSourceCode();
+        LineOffsets.push_back(0);
+        for (std::uint32_t Offset = 0; Offset < SourceCode.size(); Offset++) {
+            if (SourceCode[Offset] == '\n') {
+                LineOffsets.push_back(Offset + 1);
+            }
         }
-        Left = Right;
+    });
+    return LineOffsets;
+}
+
+LineColumn SourceFile::getLineColumn(SourceLoc Loc) const {
+    const auto& Offsets = getLineOffsets();
+    const auto Iter = std::ranges::upper_bound(Offsets, Loc.Offset);
+    const auto LineNum = static_cast<size_t>(Iter - Offsets.begin());
+    return { LineNum, Loc.Offset - *std::prev(Iter) };
+}
+
+std::string_view SourceFile::getLine(size_t LineNum) const {
+    const auto& Offsets = getLineOffsets();
+    if (LineNum > Offsets.size()) {
+        return "";
     }
-    SourceLines.push_back("");
+    const auto Start = Offsets[LineNum - 1];
+    const auto End = LineNum < Offsets.size() ? Offsets[LineNum] - 1 : getSourceCode().size();
+    return getSourceCode().substr(Start, End - Start);
 }
 
-std::span<std::string_view> SourceFile::getSourceFromRange(const SourceRange &Range) {
-    return { &SourceLines[Range.Start.LineNum - 1], &SourceLines[Range.End.LineNum] };
+std::vector<std::string_view> SourceFile::getSourceFromRange(const SourceRange &Range) const {
+    const auto Start = getLineColumn(Range.Start).LineNum;
+    const auto End = getLineColumn(Range.End).LineNum;
+    std::vector<std::string_view> Lines;
+    for (auto LineNum = Start; LineNum <= End; LineNum++) {
+        Lines.push_back(getLine(LineNum));
+    }
+    return Lines;
 }
@@ -1,18 +1,29 @@
 #pragma once
 #include "SourceLoc.h"
+#include "SourceBuffer.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
-#include <span>
 
 class SourceFile {
 public:
     SourceFile(std::string SrcString, std::string SourcePath);
-    std::string_view getSourceCode() const { return SourceCode; }
+    SourceFile(std::unique_ptr<SourceBuffer> Buffer, std::string SourcePath);
+    std::string_view getSourceCode() const { return Buffer->getContents(); }
     std::string getSourcePath() const { return SourcePath; }
-    std::span<std::string_view> getSourceFromRange(const SourceRange &Range);
+    LineColumn getLineColumn(SourceLoc Loc) const;
+    std::vector<std::string_view> getSourceFromRange(const SourceRange &Range) const;
 private:
-    std::string SourceCode, SourcePath;
-    std::vector<std::string_view> SourceLines;
+    const std::vector<std::uint32_t>& getLineOffsets() const;
+    std::string_view getLine(size_t LineNum) const;
+    std::unique_ptr<SourceBuffer> Buffer;
+    std::string SourcePath;
+    // Offset of the first character of every line, built on first use. Parser workers report errors
+    // concurrently, so the first use may come from several threads at once.
+    mutable std::vector<std::uint32_t> LineOffsets;
+    mutable std::once_flag LineOffsetsBuilt;
 };
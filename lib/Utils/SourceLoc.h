@@ -1,13 +1,20 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 
+// A location is a byte offset into its SourceFile. Line and column are
+// only computed on demand (see SourceFile::getLineColumn).
 struct SourceLoc {
-    size_t LineNum = -1, Column = -1;
+    std::uint32_t Offset = -1;
 };
 
 struct SourceRange {
     SourceLoc Start, End;
     SourceRange() = default;
-    SourceRange(SourceLoc Start, size_t Length) : Start(Start), End{ Start.LineNum, Start.Column + Length } {}
+    SourceRange(SourceLoc Start, size_t Length) : Start(Start), End{ static_cast<std::uint32_t>(Start.Offset + Length) } {}
     SourceRange(SourceLoc Start, SourceLoc End) : Start(Start), End(End) {}
+};
+
+struct LineColumn {
+    size_t LineNum = 0, Column = 0;
 };
\ No newline at end of file
@@ -1,14 +1,17 @@
 #include "SourceManager.h"
-#include <fstream>
+#include "SourceBuffer.h"
+#include "TimeReport.h"
 #include <filesystem>
 
 const SourceFile& SourceManager::getSourceFromPath(const std::string& Path) {
     const auto AbsolutePath = std::filesystem::absolute(Path).string();
 
     if (!Sources.contains(AbsolutePath)) {
-        std::ifstream File(AbsolutePath);
-        const auto SourceCode = std::string(std::istreambuf_iterator(File), std::istreambuf_iterator<char>());
-        Sources.emplace(AbsolutePath, SourceFile{SourceCode, AbsolutePath});
+        TimeScope Scope("load");
+        const auto LoadStart = std::chrono::steady_clock::now();
+        auto Buffer = SourceBuffer::fromFile(AbsolutePath);
+        Sources.try_emplace(AbsolutePath, std::move(Buffer), AbsolutePath);
+        LoadTime += std::chrono::steady_clock::now() - LoadStart;
     }
     return Sources.at(AbsolutePath);
 }
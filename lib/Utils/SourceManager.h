@@ -1,12 +1,16 @@
 #pragma once
 
 #include "SourceFile.h"
+#include <chrono>
 #include <string>
 #include <map>
 
 class SourceManager {
 public:
     const SourceFile& getSourceFromPath(const std::string &Path);
+    // Total time spent reading or mapping files, for the phase report.
+    std::chrono::nanoseconds getLoadTime() const { return LoadTime; }
 private:
     std::map<std::string, SourceFile> Sources;
+    std::chrono::nanoseconds LoadTime{};
 };
\ No newline at end of file
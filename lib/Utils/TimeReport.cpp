@@ -0,0 +1,264 @@
+#include "TimeReport.h"
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <new>
+#include <sys/resource.h>
+#include <time.h>
+
+namespace {
+    thread_local std::uint64_t NumAllocations = 0;
+    thread_local std::uint64_t NumAllocatedBytes = 0;
+
+    struct TraceEvent {
+        std::string Name;
+        std::string Detail;
+        std::chrono::steady_clock::time_point Start;
+        std::chrono::steady_clock::time_point End;
+    };
+
+    // Only the owning thread appends to a buffer. The buffers are shared with
+    // the registry so that spans of finished worker threads are kept.
+    struct TraceBuffer {
+        std::uint32_t ThreadID;
+        std::vector<TraceEvent> Events;
+    };
+
+    struct TraceRegistry {
+        std::mutex Lock;
+        std::vector<std::shared_ptr<TraceBuffer>> Buffers;
+        std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+    };
+
+    TraceRegistry& getTraceRegistry() {
+        static TraceRegistry Registry;
+        return Registry;
+    }
+
+    TraceBuffer& getThreadTraceBuffer() {
+        thread_local std::shared_ptr<TraceBuffer> Buffer;
+        if (Buffer == nullptr) {
+            auto& Registry = getTraceRegistry();
+            std::lock_guard Guard(Registry.Lock);
+            Buffer = std::make_shared<TraceBuffer>(static_cast<std::uint32_t>(Registry.Buffers.size()));
+            Registry.Buffers.push_back(Buffer);
+        }
+        return *Buffer;
+    }
+
+    std::chrono::nanoseconds threadCPUTime() {
+        timespec Time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+        return std::chrono::seconds(Time.tv_sec) + std::chrono::nanoseconds(Time.tv_nsec);
+    }
+
+    std::uint64_t peakRSSKiB() {
+        rusage Usage{};
+        getrusage(RUSAGE_SELF, &Usage);
+        return static_cast<std::uint64_t>(Usage.ru_maxrss);
+    }
+
+    double toMilliseconds(std::chrono::nanoseconds Time) {
+        return std::chrono::duration<double, std::milli>(Time).count();
+    }
+
+    std::string escapeJSON(std::string_view Str) {
+        std::string Escaped;
+        for (const auto Char : Str) {
+            if (Char == '"' || Char == '\\') {
+                Escaped += '\\';
+                Escaped += Char;
+            } else if (static_cast<unsigned char>(Char) < 0x20) {
+                Escaped += std::format("\\u{:04x}", Char);
+            } else {
+                Escaped += Char;
+            }
+        }
+        return Escaped;
+    }
+}
+
+namespace {
+    // Alignment is zero for the default alignment of operator new.
+    void* allocateCounted(std::size_t Size, std::size_t Alignment) {
+        NumAllocations++;
+        NumAllocatedBytes += Size;
+        Size = std::max<std::size_t>(Size, 1);
+        while (true) {
+            // aligned_alloc takes only sizes that are a multiple of the alignment.
+            const auto Ptr = Alignment == 0 ? std::malloc(Size)
+                                            : std::aligned_alloc(Alignment, (Size + Alignment - 1) & ~(Alignment - 1));
+            if (Ptr != nullptr) {
+                return Ptr;
+            }
+            const auto Handler = std::get_new_handler();
+            if (Handler == nullptr) {
+                throw std::bad_alloc();
+            }
+            Handler();
+        }
+    }
+}
+
+// Counting every heap allocation is what gives the per-phase allocation
+// numbers; the counters are thread-local so this stays a couple of increments.
+// The array and nothrow forms of new and delete call these.
+void* operator new(std::size_t Size) {
+    return allocateCounted(Size, 0);
+}
+
+void* operator new(std::size_t Size, std::align_val_t Alignment) {
+    return allocateCounted(Size, static_cast<std::size_t>(Alignment));
+}
+
+// GCC cannot see that the matching operator new above allocates with malloc.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* Ptr) noexcept {
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, std::size_t) noexcept {
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, std::align_val_t) noexcept {
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(Ptr);
+}
+#pragma GCC diagnostic pop
+
+TimeReport& TimeReport::get() {
+    static TimeReport Report;
+    return Report;
+}
+
+PhaseSample TimeReport::sample() {
+    return { std::chrono::steady_clock::now(), threadCPUTime(), NumAllocations, NumAllocatedBytes };
+}
+
+void TimeReport::record(std::string_view Name, const PhaseSample& Start) {
+    const auto End = sample();
+    const auto PeakRSS = peakRSSKiB();
+    std::lock_guard Guard(Lock);
+    auto Iter = PhaseIndices.find(Name);
+    if (Iter == PhaseIndices.end()) {
+        Iter = PhaseIndices.emplace(std::string(Name), Phases.size()).first;
+        Phases.push_back({ .Name = std::string(Name) });
+    }
+    auto& Stats = Phases[Iter->second];
+    Stats.Count++;
+    Stats.Wall += End.Wall - Start.Wall;
+    Stats.CPU += End.CPU - Start.CPU;
+    Stats.Allocations += End.Allocations - Start.Allocations;
+    Stats.AllocatedBytes += End.AllocatedBytes - Start.AllocatedBytes;
+    Stats.PeakRSSKiB = PeakRSS;
+}
+
+void TimeReport::addCounter(std::string_view Name, std::uint64_t Value) {
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard Guard(Lock);
+    const auto Iter = std::ranges::find(Counters, Name, &std::pair<std::string, std::uint64_t>::first);
+    if (Iter != Counters.end()) {
+        Iter->second += Value;
+    } else {
+        Counters.emplace_back(Name, Value);
+    }
+}
+
+std::vector<PhaseStats> TimeReport::getPhases() const {
+    std::lock_guard Guard(Lock);
+    return Phases;
+}
+
+void TimeReport::clear() {
+    std::lock_guard Guard(Lock);
+    Phases.clear();
+    PhaseIndices.clear();
+    Counters.clear();
+}
+
+void TimeReport::print(std::ostream& Out) const {
+    std::lock_guard Guard(Lock);
+    Out << std::format("{:<40} {:>7} {:>11} {:>11} {:>10} {:>12} {:>12}\n",
+                       "Phase", "Count", "Wall (ms)", "CPU (ms)", "Allocs", "Alloc (KiB)", "Peak RSS (KiB)");
+    for (const auto& Stats : Phases) {
+        Out << std::format("{:<40} {:>7} {:>11.3f} {:>11.3f} {:>10} {:>12} {:>12}\n",
+                           Stats.Name, Stats.Count, toMilliseconds(Stats.Wall), toMilliseconds(Stats.CPU),
+                           Stats.Allocations, Stats.AllocatedBytes / 1024, Stats.PeakRSSKiB);
+    }
+    if (!Counters.empty()) {
+        Out << "\n";
+        for (const auto& [Name, Value] : Counters) {
+            Out << std::format("{:<40} {:>7}\n", Name, Value);
+        }
+    }
+}
+
+void TimeReport::printJSON(std::ostream& Out) const {
+    std::lock_guard Guard(Lock);
+    Out << "{\"phases\":[";
+    for (std::size_t Index = 0; Index < Phases.size(); Index++) {
+        const auto& Stats = Phases[Index];
+        Out << (Index != 0 ? "," : "")
+            << std::format("{{\"name\":\"{}\",\"count\":{},\"wall_ms\":{:.3f},\"cpu_ms\":{:.3f},"
+                           "\"allocations\":{},\"allocated_bytes\":{},\"peak_rss_kib\":{}}}",
+                           escapeJSON(Stats.Name), Stats.Count, toMilliseconds(Stats.Wall), toMilliseconds(Stats.CPU),
+                           Stats.Allocations, Stats.AllocatedBytes, Stats.PeakRSSKiB);
+    }
+    Out << "],\"counters\":{";
+    for (std::size_t Index = 0; Index < Counters.size(); Index++) {
+        Out << (Index != 0 ? "," : "") << std::format("\"{}\":{}", escapeJSON(Counters[Index].first), Counters[Index].second);
+    }
+    Out << "}}\n";
+}
+
+void Trace::setEnabled(bool Enable) {
+    if (Enable) {
+        getTraceRegistry();
+    }
+    Enabled.store(Enable, std::memory_order_relaxed);
+}
+
+void Trace::record(std::string_view Name, std::string_view Detail,
+                   std::chrono::steady_clock::time_point Start, std::chrono::steady_clock::time_point End) {
+    getThreadTraceBuffer().Events.push_back({ std::string(Name), std::string(Detail), Start, End });
+}
+
+void Trace::writeJSON(std::ostream& Out) {
+    auto& Registry = getTraceRegistry();
+    std::lock_guard Guard(Registry.Lock);
+    const auto toMicroseconds = [](std::chrono::steady_clock::duration Time) {
+        return std::chrono::duration<double, std::micro>(Time).count();
+    };
+    Out << "{\"traceEvents\":[";
+    bool First = true;
+    for (const auto& Buffer : Registry.Buffers) {
+        for (const auto& Event : Buffer->Events) {
+            Out << (First ? "\n" : ",\n")
+                << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+                               escapeJSON(Event.Name), Buffer->ThreadID, toMicroseconds(Event.Start - Registry.Epoch),
+                               toMicroseconds(Event.End - Event.Start));
+            if (!Event.Detail.empty()) {
+                Out << std::format(",\"args\":{{\"detail\":\"{}\"}}", escapeJSON(Event.Detail));
+            }
+            Out << "}";
+            First = false;
+        }
+    }
+    Out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Trace::clear() {
+    auto& Registry = getTraceRegistry();
+    std::lock_guard Guard(Registry.Lock);
+    for (const auto& Buffer : Registry.Buffers) {
+        Buffer->Events.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Resources in use by the calling thread at one point in time.
+struct PhaseSample {
+    std::chrono::steady_clock::time_point Wall;
+    std::chrono::nanoseconds CPU;
+    std::uint64_t Allocations;
+    std::uint64_t AllocatedBytes;
+};
+
+// Totals for every run of a phase with the same name. CPU time is that of the
+// thread that ran the phase; peak RSS is the process high-water mark at the
+// end of the last run.
+struct PhaseStats {
+    std::string Name;
+    std::uint64_t Count = 0;
+    std::chrono::nanoseconds Wall{};
+    std::chrono::nanoseconds CPU{};
+    std::uint64_t Allocations = 0;
+    std::uint64_t AllocatedBytes = 0;
+    std::uint64_t PeakRSSKiB = 0;
+};
+
+// Process-wide collection of phase timings and counters, the equivalent of
+// -ftime-report. Nothing is recorded until it is enabled.
+class TimeReport {
+public:
+    static TimeReport& get();
+
+    static bool isEnabled() { return Enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool Enable) { Enabled.store(Enable, std::memory_order_relaxed); }
+    // Whether the optimizer should time each LLVM pass as its own phase.
+    static bool shouldTimePasses() { return TimePasses.load(std::memory_order_relaxed); }
+    static void setTimePasses(bool Enable) { TimePasses.store(Enable, std::memory_order_relaxed); }
+
+    static PhaseSample sample();
+    void record(std::string_view Name, const PhaseSample& Start);
+    void addCounter(std::string_view Name, std::uint64_t Value);
+
+    std::vector<PhaseStats> getPhases() const;
+    void clear();
+
+    void print(std::ostream& Out) const;
+    void printJSON(std::ostream& Out) const;
+private:
+    TimeReport() = default;
+
+    static inline std::atomic<bool> Enabled = false;
+    static inline std::atomic<bool> TimePasses = false;
+
+    mutable std::mutex Lock;
+    std::vector<PhaseStats> Phases;
+    std::map<std::string, std::size_t, std::less<>> PhaseIndices;
+    std::vector<std::pair<std::string, std::uint64_t>> Counters;
+};
+
+// Timeline of compiler activity in the Chrome trace event format, readable by
+// chrome://tracing and Perfetto. Each thread appends to its own buffer, so
+// write the trace only once the threads that record spans are done.
+class Trace {
+public:
+    static bool isEnabled() { return Enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool Enable);
+
+    static void record(std::string_view Name, std::string_view Detail,
+                       std::chrono::steady_clock::time_point Start, std::chrono::steady_clock::time_point End);
+    static void writeJSON(std::ostream& Out);
+    static void clear();
+private:
+    static inline std::atomic<bool> Enabled = false;
+};
+
+// Records the enclosing scope as a span of the trace. Detail, such as the
+// function being compiled, shows up in the span's arguments.
+class TraceScope {
+public:
+    explicit TraceScope(std::string_view Name, std::string_view Detail = {}) : Name(Name), Detail(Detail) {
+        if (Trace::isEnabled()) {
+            Start = std::chrono::steady_clock::now();
+        }
+    }
+    ~TraceScope() {
+        if (Start) {
+            Trace::record(Name, Detail, *Start, std::chrono::steady_clock::now());
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    std::string_view Name;
+    std::string_view Detail;
+    std::optional<std::chrono::steady_clock::time_point> Start;
+};
+
+// Records the enclosing scope as a run of the phase Name and as a trace span.
+// Name must outlive the scope.
+class TimeScope {
+public:
+    explicit TimeScope(std::string_view Name) : Name(Name), Span(Name) {
+        if (TimeReport::isEnabled()) {
+            Start = TimeReport::sample();
+        }
+    }
+    ~TimeScope() {
+        if (Start) {
+            TimeReport::get().record(Name, *Start);
+        }
+    }
+    TimeScope(const TimeScope&) = delete;
+    TimeScope& operator=(const TimeScope&) = delete;
+private:
+    std::string_view Name;
+    TraceScope Span;
+    std::optional<PhaseSample> Start;
+};
\ No newline at end of file
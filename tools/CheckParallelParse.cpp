@@ -0,0 +1,109 @@
+#include "ProgramGenerator.h"
+#include "AST/ASTPrinter.h"
+#include "AST/Module.h"
+#include "Parser/Parser.h"
+#include "Seman/Seman.h"
+#include "Utils/ErrorReporter.h"
+#include "Utils/SourceFile.h"
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Checks that a parallel parse gives what a serial one does: the same AST and the same diagnostics from the
+// parser and from Seman. Which worker reaches a declaration first changes from run to run, so each input is
+// parsed several times. Build with -fsanitize=thread to check the workers for races as well.
+namespace {
+    struct Input {
+        std::string Name;
+        std::string Code;
+    };
+
+    // Diagnostics, then the AST dump.
+    std::string check(const std::string& Code, unsigned Threads) {
+        SourceFile Source(Code, "input.unl");
+        std::ostringstream Out;
+        ErrorReporter Reporter(Out);
+        auto Mod = Parser::parseSourceFile(Source, Reporter, std::make_shared<TypeContext>(), { .Threads = Threads });
+        if (Reporter.getNumErrors() == 0) {
+            Seman SemanInfo(*Mod->TyContext, Reporter);
+            SemanInfo.visit(*Mod);
+        }
+
+        std::ostringstream Dump;
+        auto* Saved = std::cout.rdbuf(Dump.rdbuf());
+        AstPrinter Printer;
+        Mod->accept(Printer);
+        std::cout.rdbuf(Saved);
+        return Out.str() + "----\n" + Dump.str();
+    }
+
+    // A type that is never declared, used first at the end of a long function and then by every later one.
+    // Workers reach the later uses before the first, but the error must still point at the first.
+    std::string unresolvedTypeProgram(unsigned Lines) {
+        std::string Code = "fn f0(): i32 {\n    let x: i32 = 1;\n";
+        for (unsigned Line = 0; Line < Lines; ++Line) {
+            Code += "    x = x + 1;\n";
+        }
+        Code += "    let p: *Foo;\n    return 1;\n}\n";
+        for (unsigned Index = 1; Index < 50; ++Index) {
+            Code += std::format("fn f{}(a: *Foo): i32 {{\n    return 1;\n}}\n", Index);
+        }
+        return Code;
+    }
+
+    // Long declarations that each end in a syntax error. A worker only stops between declarations, so every
+    // worker reports an error, and most of them while the others are still parsing.
+    std::string syntaxErrorProgram(unsigned Functions, unsigned Lines) {
+        std::string Code;
+        for (unsigned Index = 0; Index < Functions; ++Index) {
+            Code += std::format("fn f{}(): i32 {{\n    let x: i32 = 1;\n", Index);
+            for (unsigned Line = 0; Line < Lines; ++Line) {
+                Code += "    x = x + 1;\n";
+            }
+            Code += "    x = x + 1\n    return x;\n}\n";
+        }
+        return Code;
+    }
+
+    template <typename T>
+    bool parseValue(std::string_view Text, T& Value) {
+        const auto [Ptr, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+        return Error == std::errc() && Ptr == Text.data() + Text.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned Threads = 4;
+    unsigned Runs = 5;
+    unsigned Seeds = 20;
+    if ((argc > 1 && !parseValue(argv[1], Threads)) || (argc > 2 && !parseValue(argv[2], Runs))
+        || (argc > 3 && !parseValue(argv[3], Seeds)) || argc > 4) {
+        std::cerr << "usage: " << argv[0] << " [threads] [runs] [seeds]\n";
+        return 1;
+    }
+
+    std::vector<Input> Inputs;
+    Inputs.push_back({ "unresolved type", unresolvedTypeProgram(200000) });
+    Inputs.push_back({ "syntax errors", syntaxErrorProgram(8, 20000) });
+    for (unsigned Seed = 1; Seed <= Seeds; ++Seed) {
+        GeneratorOptions Options;
+        Options.Seed = Seed;
+        Inputs.push_back({ std::format("generated, seed {}", Seed), generateProgram(Options) });
+    }
+
+    for (const auto& [Name, Code] : Inputs) {
+        const auto Expected = check(Code, 1);
+        for (unsigned Run = 0; Run < Runs; ++Run) {
+            if (check(Code, Threads) != Expected) {
+                std::cerr << Name << ": " << Threads << " threads differ from a serial parse\n";
+                return 1;
+            }
+        }
+    }
+    std::cout << Inputs.size() << " inputs match\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "ProgramGenerator.h"
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+    template <typename T>
+    bool parseValue(std::string_view Text, T& Value) {
+        const auto [Ptr, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+        return Error == std::errc() && Ptr == Text.data() + Text.size();
+    }
+
+    bool parseOption(std::string_view Arg, GeneratorOptions& Options) {
+        if (Arg == "--codegen-subset") {
+            Options.CodeGenSubset = true;
+            return true;
+        }
+        const auto Equals = Arg.find('=');
+        if (Equals == std::string_view::npos) {
+            return false;
+        }
+        const auto Name = Arg.substr(0, Equals);
+        const auto Value = Arg.substr(Equals + 1);
+        if (Name == "--seed") return parseValue(Value, Options.Seed);
+        if (Name == "--functions") return parseValue(Value, Options.NumFunctions);
+        if (Name == "--structs") return parseValue(Value, Options.NumStructs);
+        if (Name == "--fields") return parseValue(Value, Options.MaxFields);
+        if (Name == "--params") return parseValue(Value, Options.MaxParams);
+        if (Name == "--statements") return parseValue(Value, Options.StatementsPerBlock);
+        if (Name == "--nesting") return parseValue(Value, Options.MaxNesting);
+        if (Name == "--expr-depth") return parseValue(Value, Options.MaxExprDepth);
+        if (Name == "--type-depth") return parseValue(Value, Options.MaxTypeDepth);
+        if (Name == "--call-density") return parseValue(Value, Options.CallDensity);
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions Options;
+    for (int Index = 1; Index < argc; Index++) {
+        if (!parseOption(argv[Index], Options)) {
+            std::cerr << "usage: " << argv[0] << " [--seed=N] [--functions=N] [--structs=N] [--fields=N] [--params=N]"
+                      << " [--statements=N] [--nesting=N] [--expr-depth=N] [--type-depth=N] [--call-density=P]"
+                      << " [--codegen-subset]\n";
+            return 1;
+        }
+    }
+    std::cout << generateProgram(Options);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,582 @@
+#include "ProgramGenerator.h"
+#include <array>
+#include <deque>
+#include <format>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // The generator's view of a unl type. Types are uniqued by spelling, so
+    // they compare by address like the compiler's own.
+    struct GenType {
+        enum class Kind { Scalar, Struct, Pointer, Array };
+        Kind TyKind;
+        std::string Spelling;
+        const GenType* Element = nullptr;
+        std::uint32_t Size = 0;
+        std::uint32_t StructIndex = 0;
+
+        bool isScalar() const { return TyKind == Kind::Scalar; }
+        bool isBool() const { return Spelling == "bool"; }
+        bool isArithmetic() const { return isScalar() && !isBool(); }
+        bool isInteger() const { return isArithmetic() && Spelling[0] != 'f'; }
+        bool isPointer() const { return TyKind == Kind::Pointer; }
+        bool isArray() const { return TyKind == Kind::Array; }
+        bool isStruct() const { return TyKind == Kind::Struct; }
+    };
+
+    struct StructInfo {
+        std::string Name;
+        std::vector<std::pair<std::string, const GenType*>> Fields;
+    };
+
+    struct FunctionInfo {
+        std::string Name;
+        // Declared parameter types; array parameters take a pointer argument.
+        std::vector<const GenType*> Params;
+        const GenType* Return;
+    };
+
+    struct Variable {
+        std::string Name;
+        const GenType* Ty;
+    };
+
+    // An expression that names storage: a variable, a field, a dereference or
+    // an element. Ty is the type of the expression after array decay.
+    struct Place {
+        std::string Spelling;
+        const GenType* Ty;
+        bool Assignable;
+    };
+
+    constexpr std::array<std::string_view, 10> ArithmeticNames = {
+        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64"
+    };
+
+    class Generator {
+    public:
+        explicit Generator(const GeneratorOptions& Options) : Options(Options), State(Options.Seed) {}
+
+        std::string run();
+    private:
+        // splitmix64; unlike the standard distributions its output is the same
+        // on every platform.
+        std::uint64_t next() {
+            State += 0x9e3779b97f4a7c15ULL;
+            auto Value = State;
+            Value = (Value ^ (Value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            Value = (Value ^ (Value >> 27)) * 0x94d049bb133111ebULL;
+            return Value ^ (Value >> 31);
+        }
+        std::uint32_t below(std::size_t Bound) { return static_cast<std::uint32_t>(next() % Bound); }
+        bool chance(double Probability) { return static_cast<double>(next() >> 11) * 0x1.0p-53 < Probability; }
+        template <typename T>
+        const T& pick(const std::vector<T>& Elems) { return Elems[below(Elems.size())]; }
+
+        const GenType* intern(GenType Ty);
+        const GenType* scalar(std::string_view Name);
+        const GenType* pointerTo(const GenType* Element);
+        const GenType* arrayOf(const GenType* Element, std::uint32_t Size);
+        const GenType* decay(const GenType* Ty) { return Ty->isArray() ? pointerTo(Ty->Element) : Ty; }
+
+        const GenType* randomScalar(bool AllowBool = true);
+        const GenType* randomType(bool AllowArrays, std::uint32_t MaxStruct, std::uint32_t Depth = 0);
+
+        void generateStructs();
+        void generateSignatures();
+        void generateFunction(const FunctionInfo& Function);
+        void generateBlock(std::uint32_t Depth);
+        void generateStmt(std::uint32_t Depth);
+        void generateLet(std::uint32_t Depth);
+        void generateAssign(std::uint32_t Depth);
+        void generateIf(std::uint32_t Depth);
+        void generateWhile(std::uint32_t Depth);
+        void generateCallStmt(std::uint32_t Depth);
+
+        std::string generateExpr(const GenType* Ty, std::uint32_t Depth);
+        std::string generateLeaf(const GenType* Ty, std::uint32_t Depth);
+        std::optional<std::string> generateCall(const GenType* Ty, std::uint32_t Depth);
+        std::string generateCallArgs(const FunctionInfo& Function, std::uint32_t Depth);
+        std::string generateArithmetic(const GenType* Ty, std::uint32_t Depth);
+        std::string generateBool(std::uint32_t Depth);
+        std::string generatePointer(const GenType* Ty, std::uint32_t Depth);
+        std::string generateInit(const GenType* Ty);
+        std::string generateLiteral(const GenType* Ty);
+        std::string temporary(const GenType* Ty);
+
+        std::vector<Place> collectPlaces();
+        void addPlaces(std::vector<Place>& Places, const std::string& Spelling, const GenType* Declared,
+                       bool Assignable, std::uint32_t Depth);
+
+        void line(std::uint32_t Depth, std::string_view Text);
+        std::string freshName(char Prefix) { return std::format("{}{}", Prefix, NextLocal++); }
+
+        const GeneratorOptions& Options;
+        std::uint64_t State;
+        std::deque<GenType> TypeStorage;
+        std::map<std::string, const GenType*, std::less<>> Types;
+        std::vector<StructInfo> Structs;
+        std::vector<FunctionInfo> Functions;
+
+        std::string Out;
+        // The function being generated: its body, the temporaries it needs and
+        // the variables in scope with the sizes of the enclosing scopes.
+        const FunctionInfo* Current = nullptr;
+        std::size_t NumCallable = 0;
+        std::string Body;
+        std::string Temporaries;
+        std::map<std::string, std::string, std::less<>> TemporaryByType;
+        std::vector<Variable> Scope;
+        std::uint32_t NextLocal = 0;
+    };
+
+    const GenType* Generator::intern(GenType Ty) {
+        const auto Iter = Types.find(Ty.Spelling);
+        if (Iter != Types.end()) {
+            return Iter->second;
+        }
+        const auto& Stored = TypeStorage.emplace_back(std::move(Ty));
+        Types.emplace(Stored.Spelling, &Stored);
+        return &Stored;
+    }
+
+    const GenType* Generator::scalar(std::string_view Name) {
+        return intern({ .TyKind = GenType::Kind::Scalar, .Spelling = std::string(Name) });
+    }
+
+    const GenType* Generator::pointerTo(const GenType* Element) {
+        return intern({ .TyKind = GenType::Kind::Pointer, .Spelling = "*" + Element->Spelling, .Element = Element });
+    }
+
+    const GenType* Generator::arrayOf(const GenType* Element, std::uint32_t Size) {
+        return intern({ .TyKind = GenType::Kind::Array, .Spelling = std::format("[{}, {}]", Element->Spelling, Size),
+                        .Element = Element, .Size = Size });
+    }
+
+    const GenType* Generator::randomScalar(bool AllowBool) {
+        if (AllowBool && chance(0.2)) {
+            return scalar("bool");
+        }
+        // Mostly i32, the type of integer literals.
+        if (chance(0.5)) {
+            return scalar("i32");
+        }
+        return scalar(ArithmeticNames[below(ArithmeticNames.size())]);
+    }
+
+    // A type built from scalars, the first MaxStruct structs, pointers and,
+    // if allowed, arrays. Pointers never point to arrays.
+    const GenType* Generator::randomType(bool AllowArrays, std::uint32_t MaxStruct, std::uint32_t Depth) {
+        if (Options.CodeGenSubset) {
+            return randomScalar();
+        }
+        const auto Roll = below(10);
+        if (Depth < Options.MaxTypeDepth && Roll < 2) {
+            return pointerTo(randomType(false, MaxStruct, Depth + 1));
+        }
+        if (AllowArrays && Depth < Options.MaxTypeDepth && Roll < 3) {
+            return arrayOf(randomType(true, MaxStruct, Depth + 1), 1 + below(4));
+        }
+        if (MaxStruct > 0 && Roll < 5) {
+            const auto Index = below(MaxStruct);
+            return intern({ .TyKind = GenType::Kind::Struct, .Spelling = Structs[Index].Name, .StructIndex = Index });
+        }
+        return randomScalar();
+    }
+
+    std::string Generator::run() {
+        if (!Options.CodeGenSubset) {
+            generateStructs();
+        }
+        generateSignatures();
+        for (const auto& Function : Functions) {
+            generateFunction(Function);
+        }
+        return std::move(Out);
+    }
+
+    // Fields hold earlier structs by value, so struct types never contain
+    // themselves; pointers may refer to any struct, including this one.
+    void Generator::generateStructs() {
+        for (std::uint32_t Index = 0; Index < Options.NumStructs; Index++) {
+            Structs.push_back({ std::format("S{}", Index), {} });
+        }
+        for (std::uint32_t Index = 0; Index < Options.NumStructs; Index++) {
+            auto& Struct = Structs[Index];
+            const auto NumFields = 1 + below(std::max(Options.MaxFields, 1u));
+            for (std::uint32_t Field = 0; Field < NumFields; Field++) {
+                const GenType* Ty = nullptr;
+                if (chance(0.15)) {
+                    const auto Target = below(Options.NumStructs);
+                    Ty = pointerTo(intern({ .TyKind = GenType::Kind::Struct, .Spelling = Structs[Target].Name,
+                                            .StructIndex = Target }));
+                } else {
+                    Ty = randomType(true, Index);
+                }
+                Struct.Fields.emplace_back(std::format("m{}", Field), Ty);
+            }
+            Out += std::format("struct {} {{ ", Struct.Name);
+            for (std::size_t Field = 0; Field < Struct.Fields.size(); Field++) {
+                Out += std::format("{}{}: {}", Field != 0 ? ", " : "", Struct.Fields[Field].first,
+                                   Struct.Fields[Field].second->Spelling);
+            }
+            Out += " }\n";
+        }
+    }
+
+    void Generator::generateSignatures() {
+        const auto NumStructs = static_cast<std::uint32_t>(Structs.size());
+        for (std::uint32_t Index = 0; Index < Options.NumFunctions; Index++) {
+            FunctionInfo Function{ std::format("f{}", Index), {}, nullptr };
+            const auto NumParams = below(Options.MaxParams + 1);
+            for (std::uint32_t Param = 0; Param < NumParams; Param++) {
+                Function.Params.push_back(randomType(true, NumStructs));
+            }
+            // CodeGen cannot return without a value yet.
+            Function.Return = !Options.CodeGenSubset && chance(0.1) ? scalar("void") : randomType(false, NumStructs);
+            Functions.push_back(std::move(Function));
+        }
+        Functions.push_back({ "main", {}, scalar("i32") });
+    }
+
+    void Generator::generateFunction(const FunctionInfo& Function) {
+        Current = &Function;
+        NumCallable = static_cast<std::size_t>(&Function - Functions.data());
+        Body.clear();
+        Temporaries.clear();
+        TemporaryByType.clear();
+        Scope.clear();
+        NextLocal = 0;
+
+        std::string Params;
+        for (std::size_t Index = 0; Index < Function.Params.size(); Index++) {
+            const auto Name = std::format("p{}", Index);
+            Params += std::format("{}{}: {}", Index != 0 ? ", " : "", Name, Function.Params[Index]->Spelling);
+            Scope.push_back({ Name, Function.Params[Index] });
+        }
+        generateBlock(1);
+        if (Function.Return->Spelling == "void") {
+            line(1, "return;");
+        } else {
+            line(1, std::format("return {};", generateExpr(Function.Return, 0)));
+        }
+        Out += std::format("fn {}({}): {} {{\n", Function.Name, Params, Function.Return->Spelling);
+        Out += Temporaries;
+        Out += Body;
+        Out += "}\n";
+    }
+
+    void Generator::generateBlock(std::uint32_t Depth) {
+        const auto ScopeSize = Scope.size();
+        const auto NumStmts = 1 + below(std::max(Options.StatementsPerBlock, 1u));
+        for (std::uint32_t Index = 0; Index < NumStmts; Index++) {
+            generateStmt(Depth);
+        }
+        Scope.resize(ScopeSize);
+    }
+
+    void Generator::generateStmt(std::uint32_t Depth) {
+        const auto Roll = below(100);
+        const bool CanNest = Depth <= Options.MaxNesting;
+        if (Roll < 35) {
+            return generateLet(Depth);
+        }
+        if (Roll < 60) {
+            return generateAssign(Depth);
+        }
+        if (Roll < 75 && CanNest) {
+            return generateIf(Depth);
+        }
+        if (Roll < 85 && CanNest) {
+            return generateWhile(Depth);
+        }
+        if (Roll < 95 && NumCallable > 0) {
+            return generateCallStmt(Depth);
+        }
+        if (CanNest) {
+            line(Depth, "{");
+            generateBlock(Depth + 1);
+            line(Depth, "}");
+            return;
+        }
+        generateLet(Depth);
+    }
+
+    void Generator::generateLet(std::uint32_t Depth) {
+        const auto Ty = randomType(true, static_cast<std::uint32_t>(Structs.size()));
+        const auto Name = freshName('v');
+        if (chance(0.2) && !Ty->isArray()) {
+            line(Depth, std::format("let {}: {};", Name, Ty->Spelling));
+        } else {
+            const auto Init = Ty->isArray() ? generateInit(Ty) : generateExpr(Ty, 0);
+            line(Depth, std::format("let {}: {} = {};", Name, Ty->Spelling, Init));
+        }
+        Scope.push_back({ Name, Ty });
+    }
+
+    void Generator::generateAssign(std::uint32_t Depth) {
+        std::vector<Place> Targets;
+        for (auto& Target : collectPlaces()) {
+            if (Target.Assignable) {
+                Targets.push_back(std::move(Target));
+            }
+        }
+        if (Targets.empty()) {
+            return generateLet(Depth);
+        }
+        const auto& Target = pick(Targets);
+        line(Depth, std::format("{} = {};", Target.Spelling, generateExpr(Target.Ty, 0)));
+    }
+
+    void Generator::generateIf(std::uint32_t Depth) {
+        line(Depth, std::format("if ({}) {{", generateExpr(scalar("bool"), 0)));
+        generateBlock(Depth + 1);
+        if (Current->Return->Spelling != "void" && chance(0.2)) {
+            line(Depth + 1, std::format("return {};", generateExpr(Current->Return, 0)));
+        }
+        if (chance(0.4)) {
+            line(Depth, "} else {");
+            generateBlock(Depth + 1);
+        }
+        line(Depth, "}");
+    }
+
+    // Loops are bounded: by a counter where comparisons are available, and
+    // otherwise by a condition that is always false.
+    void Generator::generateWhile(std::uint32_t Depth) {
+        const auto Cond = generateExpr(scalar("bool"), 1);
+        if (Options.CodeGenSubset) {
+            line(Depth, std::format("while ({} && false) {{", Cond));
+            generateBlock(Depth + 1);
+            line(Depth, "}");
+            return;
+        }
+        const auto Counter = freshName('c');
+        line(Depth, std::format("let {}: i32 = {};", Counter, 1 + below(4)));
+        line(Depth, std::format("while ({} > 1 && {}) {{", Counter, Cond));
+        generateBlock(Depth + 1);
+        line(Depth + 1, std::format("{} = {} - 1;", Counter, Counter));
+        line(Depth, "}");
+    }
+
+    void Generator::generateCallStmt(std::uint32_t Depth) {
+        const auto& Callee = Functions[below(NumCallable)];
+        line(Depth, std::format("{}({});", Callee.Name, generateCallArgs(Callee, 1)));
+    }
+
+    std::string Generator::generateExpr(const GenType* Ty, std::uint32_t Depth) {
+        if (Depth < Options.MaxExprDepth && chance(0.6)) {
+            if (Ty->isArithmetic()) {
+                return generateArithmetic(Ty, Depth);
+            }
+            if (Ty->isBool()) {
+                return generateBool(Depth);
+            }
+            if (Ty->isPointer()) {
+                return generatePointer(Ty, Depth);
+            }
+        }
+        return generateLeaf(Ty, Depth);
+    }
+
+    std::string Generator::generateLeaf(const GenType* Ty, std::uint32_t Depth) {
+        if (Depth < Options.MaxExprDepth && chance(Options.CallDensity)) {
+            if (auto Call = generateCall(Ty, Depth)) {
+                return *Call;
+            }
+        }
+        if (!Ty->isScalar() || chance(0.6)) {
+            std::vector<std::string> Reads;
+            for (const auto& Read : collectPlaces()) {
+                if (Read.Ty == Ty) {
+                    Reads.push_back(Read.Spelling);
+                }
+            }
+            if (!Reads.empty()) {
+                return pick(Reads);
+            }
+        }
+        if (Ty->isScalar()) {
+            return generateLiteral(Ty);
+        }
+        // A pointer to an array only comes from the decay of an array of arrays.
+        if (Ty->isPointer() && Ty->Element->isArray()) {
+            return temporary(arrayOf(Ty->Element, 1));
+        }
+        if (Ty->isPointer()) {
+            return "&" + temporary(Ty->Element);
+        }
+        return temporary(Ty);
+    }
+
+    std::optional<std::string> Generator::generateCall(const GenType* Ty, std::uint32_t Depth) {
+        std::vector<std::size_t> Candidates;
+        for (std::size_t Index = 0; Index < NumCallable; Index++) {
+            if (Functions[Index].Return == Ty) {
+                Candidates.push_back(Index);
+            }
+        }
+        if (Candidates.empty()) {
+            return std::nullopt;
+        }
+        const auto& Callee = Functions[pick(Candidates)];
+        return std::format("{}({})", Callee.Name, generateCallArgs(Callee, Depth + 1));
+    }
+
+    std::string Generator::generateCallArgs(const FunctionInfo& Function, std::uint32_t Depth) {
+        std::string Args;
+        for (std::size_t Index = 0; Index < Function.Params.size(); Index++) {
+            Args += (Index != 0 ? ", " : "") + generateExpr(decay(Function.Params[Index]), Depth);
+        }
+        return Args;
+    }
+
+    std::string Generator::generateArithmetic(const GenType* Ty, std::uint32_t Depth) {
+        const auto Roll = below(10);
+        if (Roll < 2) {
+            return std::format("-{}", generateLeaf(Ty, Depth + 1));
+        }
+        if (Roll < 4) {
+            const auto From = Options.CodeGenSubset ? scalar("i32") : randomScalar(true);
+            return std::format("({} as {})", generateExpr(From, Depth + 1), Ty->Spelling);
+        }
+        if (Options.CodeGenSubset) {
+            return generateLeaf(Ty, Depth);
+        }
+        constexpr std::array<std::string_view, 5> Ops = { "+", "-", "*", "/", "+" };
+        return std::format("({} {} {})", generateExpr(Ty, Depth + 1), Ops[below(Ops.size())],
+                           generateExpr(Ty, Depth + 1));
+    }
+
+    std::string Generator::generateBool(std::uint32_t Depth) {
+        const auto Roll = below(10);
+        if (Roll < 3) {
+            return std::format("({} {} {})", generateExpr(scalar("bool"), Depth + 1), chance(0.5) ? "&&" : "||",
+                               generateExpr(scalar("bool"), Depth + 1));
+        }
+        if (Roll < 4 || Options.CodeGenSubset) {
+            const auto From = Options.CodeGenSubset ? scalar("i32") : randomScalar(false);
+            return std::format("({} as bool)", generateExpr(From, Depth + 1));
+        }
+        if (Roll < 5) {
+            return std::format("!{}", generateLeaf(scalar("bool"), Depth + 1));
+        }
+        constexpr std::array<std::string_view, 6> Ops = { "<", "<=", ">", ">=", "==", "!=" };
+        const auto Operands = chance(0.1) ? pointerTo(randomScalar()) : randomScalar(false);
+        return std::format("({} {} {})", generateExpr(Operands, Depth + 1), Ops[below(Ops.size())],
+                           generateExpr(Operands, Depth + 1));
+    }
+
+    std::string Generator::generatePointer(const GenType* Ty, std::uint32_t Depth) {
+        if (chance(0.3)) {
+            return std::format("({} + {})", generateLeaf(Ty, Depth + 1), generateLiteral(scalar("i32")));
+        }
+        std::vector<std::string> Targets;
+        for (const auto& Target : collectPlaces()) {
+            if (Target.Ty == Ty->Element && Target.Assignable) {
+                Targets.push_back(Target.Spelling);
+            }
+        }
+        if (Targets.empty()) {
+            return generateLeaf(Ty, Depth);
+        }
+        return "&" + pick(Targets);
+    }
+
+    // Array initializers are the only expressions of array type.
+    std::string Generator::generateInit(const GenType* Ty) {
+        if (!Ty->isArray()) {
+            return generateExpr(Ty, 1);
+        }
+        std::string Init = "{";
+        for (std::uint32_t Index = 0; Index < Ty->Size; Index++) {
+            Init += (Index != 0 ? ", " : "") + generateInit(Ty->Element);
+        }
+        return Init + "}";
+    }
+
+    // The lexer starts integers at 1-9, so literals are never 0.
+    std::string Generator::generateLiteral(const GenType* Ty) {
+        if (Ty->isBool()) {
+            return chance(0.5) ? "true" : "false";
+        }
+        const auto Value = 1 + below(99);
+        if (Ty->Spelling == "i32") {
+            return std::to_string(Value);
+        }
+        return std::format("({} as {})", Value, Ty->Spelling);
+    }
+
+    // A variable of type Ty declared at the top of the function, for values
+    // that cannot be written as literals.
+    std::string Generator::temporary(const GenType* Ty) {
+        const auto Iter = TemporaryByType.find(Ty->Spelling);
+        if (Iter != TemporaryByType.end()) {
+            return Iter->second;
+        }
+        const auto Name = freshName('t');
+        Temporaries += std::format("    let {}: {};\n", Name, Ty->Spelling);
+        TemporaryByType.emplace(Ty->Spelling, Name);
+        return Name;
+    }
+
+    std::vector<Place> Generator::collectPlaces() {
+        std::vector<Place> Places;
+        for (const auto& Var : Scope) {
+            addPlaces(Places, Var.Name, Var.Ty, true, 0);
+        }
+        for (const auto& [Spelling, Name] : TemporaryByType) {
+            addPlaces(Places, Name, Types.find(Spelling)->second, true, 0);
+        }
+        return Places;
+    }
+
+    // Subscripts go only through variables and pointers: a field or element of
+    // array type does not decay, so it cannot be indexed.
+    void Generator::addPlaces(std::vector<Place>& Places, const std::string& Spelling, const GenType* Declared,
+                              bool Assignable, std::uint32_t Depth) {
+        if (Options.CodeGenSubset) {
+            Places.push_back({ Spelling, Declared, true });
+            return;
+        }
+        const bool IsArray = Declared->isArray();
+        const auto Ty = decay(Declared);
+        if (IsArray && Depth != 0) {
+            return;
+        }
+        Places.push_back({ Spelling, Ty, Assignable && !IsArray });
+        if (Depth >= 2) {
+            return;
+        }
+        if (Ty->isStruct()) {
+            for (const auto& [Field, FieldTy] : Structs[Ty->StructIndex].Fields) {
+                addPlaces(Places, std::format("{}.{}", Spelling, Field), FieldTy, Assignable, Depth + 1);
+            }
+        } else if (Ty->isPointer()) {
+            if (!Ty->Element->isArray()) {
+                addPlaces(Places, std::format("(*{})", Spelling), Ty->Element, true, Depth + 1);
+            }
+            if (Depth == 0) {
+                const auto Element = Ty->Element;
+                if (Element->isArray()) {
+                    Places.push_back({ std::format("{}[1]", Spelling), decay(Element), false });
+                } else {
+                    addPlaces(Places, std::format("{}[1]", Spelling), Element, true, Depth + 1);
+                }
+            }
+        }
+    }
+
+    void Generator::line(std::uint32_t Depth, std::string_view Text) {
+        Body.append(Depth * 4, ' ');
+        Body += Text;
+        Body += '\n';
+    }
+}
+
+std::string generateProgram(const GeneratorOptions& Options) {
+    return Generator(Options).run();
+}
\ No newline at end of file
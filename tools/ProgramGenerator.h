@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+struct GeneratorOptions {
+    std::uint64_t Seed = 1;
+    std::uint32_t NumFunctions = 100;
+    std::uint32_t NumStructs = 8;
+    std::uint32_t MaxFields = 4;
+    std::uint32_t MaxParams = 3;
+    std::uint32_t StatementsPerBlock = 6;
+    // Nesting of if, while and block statements.
+    std::uint32_t MaxNesting = 3;
+    // Operator depth of expressions, which bounds their size.
+    std::uint32_t MaxExprDepth = 3;
+    // How many pointer and array levels a type may have, as in **i32 or [[i8, 2], 3].
+    std::uint32_t MaxTypeDepth = 2;
+    // Chance that an expression becomes a call when a function of the right
+    // type exists. Calls only go to earlier functions, so the call graph is
+    // acyclic and every program terminates.
+    double CallDensity = 0.3;
+    // Only emit what CodeGen can compile: scalar types, unary minus, casts
+    // from integers, && and ||, calls and assignments to variables.
+    bool CodeGenSubset = false;
+};
+
+// Generates a program that passes Seman, ending in 'fn main(): i32'. The
+// output depends only on Options, including across platforms. Operators that
+// Seman does not check yet (%, |, ^, ~, << and >>) are never emitted.
+std::string generateProgram(const GeneratorOptions& Options);
\ No newline at end of file